@@ -0,0 +1,236 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_mont.h"
+#include "m_mont_cache.h"
+
+// mont_ctx_t in 16-bit words, rounded up
+#define CTX_WORDS ((sizeof(mont_ctx_t) + 1) / 2)
+
+/*
+ * ctx holds the words of a mont_ctx_t and is only written between two
+ * increments of seq, an odd seq means a write is in progress. Readers may
+ * still load words while a writer stores them, so every word is an atomic
+ * and the copies are word by word with relaxed loads and stores, seq alone
+ * orders them. hash is a copy of the key hash readers can test without
+ * copying ctx. An entry with last_used = 0 is empty.
+ */
+typedef struct {
+    atomic_uint seq;
+    atomic_uint_fast64_t hash;
+    atomic_uint_fast64_t last_used;
+    atomic_uint_least16_t ctx[CTX_WORDS];
+} mont_cache_entry_t;
+
+struct mont_cache {
+    mont_cache_entry_t * entries; // sets * M_MONT_CACHE_WAYS
+    uint32_t set_mask;
+    pthread_mutex_t writer;       // serializes installs, never taken by hits
+    atomic_uint_fast64_t clock;
+    atomic_uint_fast64_t hits;
+    atomic_uint_fast64_t misses;
+};
+
+/**
+ * FNV-1a over the wordlength and the modulus words
+ */
+static uint64_t modulus_hash(uint16_t * p, uint8_t wordlength) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    int i;
+
+    h = (h ^ wordlength) * 0x100000001b3ULL;
+    for (i = 0; i < wordlength; i++) {
+        h = (h ^ (p[i] & 0xFF)) * 0x100000001b3ULL;
+        h = (h ^ (p[i] >> 8)) * 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * Copies the context words of an entry out, the copy may be torn if a
+ * writer is active
+ */
+static void entry_load(mont_cache_entry_t * e, mont_ctx_t * ctx) {
+    uint16_t w[CTX_WORDS];
+    size_t i;
+
+    for (i = 0; i < CTX_WORDS; i++) {
+        w[i] = (uint16_t) atomic_load_explicit(&e->ctx[i], memory_order_relaxed);
+    }
+    memcpy(ctx, w, sizeof(mont_ctx_t));
+}
+
+/**
+ * Consistent copy of the context of an entry whose hash matches.
+ * Returns 1 if it is the context of p
+ */
+static int entry_read(mont_cache_entry_t * e, mont_ctx_t * ctx, uint64_t hash, uint16_t * p, uint8_t wordlength) {
+    unsigned s1, s2;
+
+    for (;;) {
+        s1 = atomic_load_explicit(&e->seq, memory_order_acquire);
+        if (0 == (s1 & 1)) {
+            if (atomic_load_explicit(&e->hash, memory_order_relaxed) != hash) {
+                return 0;
+            }
+            entry_load(e, ctx);
+            atomic_thread_fence(memory_order_acquire);
+            s2 = atomic_load_explicit(&e->seq, memory_order_relaxed);
+            if (s1 == s2) {
+                break;
+            }
+        }
+    }
+    //The copy is private, compare the full key
+    return (ctx->wordlength == wordlength) && (1 == are_mp_equal(ctx->p, p, wordlength));
+}
+
+/**
+ * Replaces the context of an entry, with the writer lock held
+ */
+static void entry_write(mont_cache_entry_t * e, mont_ctx_t * ctx, uint64_t hash, uint64_t now) {
+    unsigned s = atomic_load_explicit(&e->seq, memory_order_relaxed);
+    uint16_t w[CTX_WORDS];
+    size_t i;
+
+    w[CTX_WORDS - 1] = 0;
+    memcpy(w, ctx, sizeof(mont_ctx_t));
+    atomic_store_explicit(&e->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&e->hash, hash, memory_order_relaxed);
+    for (i = 0; i < CTX_WORDS; i++) {
+        atomic_store_explicit(&e->ctx[i], w[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&e->seq, s + 2, memory_order_release);
+    atomic_store_explicit(&e->last_used, now, memory_order_relaxed);
+}
+
+mont_cache_t * mont_cache_create(uint32_t capacity) {
+    mont_cache_t * cache;
+    uint32_t sets = 1;
+    uint32_t i;
+    size_t j;
+
+    while ((sets < (1UL << 24)) && ((uint64_t) sets * M_MONT_CACHE_WAYS < capacity)) {
+        sets <<= 1;
+    }
+    cache = (mont_cache_t *) malloc(sizeof(mont_cache_t));
+    if (NULL == cache) {
+        return NULL;
+    }
+    cache->entries = (mont_cache_entry_t *) calloc((size_t) sets * M_MONT_CACHE_WAYS, sizeof(mont_cache_entry_t));
+    if (NULL == cache->entries) {
+        free(cache);
+        return NULL;
+    }
+    for (i = 0; i < sets * M_MONT_CACHE_WAYS; i++) {
+        atomic_init(&cache->entries[i].seq, 0);
+        atomic_init(&cache->entries[i].hash, 0);
+        atomic_init(&cache->entries[i].last_used, 0);
+        for (j = 0; j < CTX_WORDS; j++) {
+            atomic_init(&cache->entries[i].ctx[j], 0);
+        }
+    }
+    cache->set_mask = sets - 1;
+    if (0 != pthread_mutex_init(&cache->writer, NULL)) {
+        free(cache->entries);
+        free(cache);
+        return NULL;
+    }
+    atomic_init(&cache->clock, 0);
+    atomic_init(&cache->hits, 0);
+    atomic_init(&cache->misses, 0);
+    return cache;
+}
+
+void mont_cache_destroy(mont_cache_t * cache) {
+    if (NULL == cache) {
+        return;
+    }
+    pthread_mutex_destroy(&cache->writer);
+    free(cache->entries);
+    free(cache);
+}
+
+int mont_cache_get(mont_cache_t * cache, mont_ctx_t * ctx, uint16_t * p, uint8_t wordlength) {
+    uint64_t hash = modulus_hash(p, wordlength);
+    mont_cache_entry_t * set = &cache->entries[(hash & cache->set_mask) * M_MONT_CACHE_WAYS];
+    mont_cache_entry_t * victim;
+    mont_ctx_t way;
+    uint64_t now;
+    int i;
+
+    //1. Lock-free lookup
+    for (i = 0; i < M_MONT_CACHE_WAYS; i++) {
+        if (1 == entry_read(&set[i], ctx, hash, p, wordlength)) {
+            now = atomic_fetch_add_explicit(&cache->clock, 1, memory_order_relaxed) + 1;
+            atomic_store_explicit(&set[i].last_used, now, memory_order_relaxed);
+            atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+            return 1;
+        }
+    }
+
+    //2. Miss, the doublings of mont_setup run outside the lock
+    atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+    if (0 == mont_setup(ctx, p, wordlength)) {
+        return 0;
+    }
+
+    //3. Install over the least recently used way, an empty one has never been
+    //   used, unless another thread installed p meanwhile. Only writers store
+    //   ctx and they hold the lock, so the copies here are not torn
+    pthread_mutex_lock(&cache->writer);
+    now = atomic_fetch_add_explicit(&cache->clock, 1, memory_order_relaxed) + 1;
+    victim = &set[0];
+    for (i = 0; i < M_MONT_CACHE_WAYS; i++) {
+        if (atomic_load_explicit(&set[i].hash, memory_order_relaxed) == hash) {
+            entry_load(&set[i], &way);
+            if ((way.wordlength == wordlength) && (1 == are_mp_equal(way.p, p, wordlength))) {
+                victim = NULL;
+                break;
+            }
+        }
+        if (atomic_load_explicit(&set[i].last_used, memory_order_relaxed)
+                < atomic_load_explicit(&victim->last_used, memory_order_relaxed)) {
+            victim = &set[i];
+        }
+    }
+    if (NULL != victim) {
+        entry_write(victim, ctx, hash, now);
+    }
+    pthread_mutex_unlock(&cache->writer);
+    return 1;
+}
+
+void mont_cache_stats(mont_cache_t * cache, uint64_t * hits, uint64_t * misses) {
+    *hits = atomic_load_explicit(&cache->hits, memory_order_relaxed);
+    *misses = atomic_load_explicit(&cache->misses, memory_order_relaxed);
+}
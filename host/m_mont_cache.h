@@ -0,0 +1,62 @@
+/*
+ * File:   m_mont_cache.h
+ *
+ * Bounded cache of Montgomery contexts keyed by the modulus, for hosts that
+ * see many distinct moduli (e.g. RSA verification for many public keys) and
+ * would otherwise redo mont_setup on every request, whose R mod p and
+ * R^2 mod p by doubling take 2*16*wordlength modular additions.
+ *
+ * The cache is set associative: a hash of the modulus words picks a set of
+ * M_MONT_CACHE_WAYS entries and the least recently used entry of the set is
+ * replaced on a miss. Lookups take no lock, every entry is guarded by a
+ * sequence counter and readers retry if a writer replaced it under them.
+ * Misses run mont_setup unlocked and only take the writer lock to install
+ * the result. Needs C11 atomics and POSIX threads.
+ */
+
+#ifndef M_MONT_CACHE_H
+#define	M_MONT_CACHE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+#include "m_arith_mont.h"
+
+#define M_MONT_CACHE_WAYS 4
+
+typedef struct mont_cache mont_cache_t;
+
+/**
+ * Creates a cache for at least capacity moduli, rounded up to a power of
+ * two number of sets
+ *
+ * @return the cache, NULL if out of memory or the writer lock cannot be created
+ */
+mont_cache_t * mont_cache_create(uint32_t capacity);
+
+/**
+ * Frees a cache, no lookups may be in progress
+ */
+void mont_cache_destroy(mont_cache_t * cache);
+
+/**
+ * Fills ctx for the modulus p, from the cache if p was seen recently and
+ * with mont_setup otherwise. Safe to call from any number of threads.
+ * Input: p odd, p > 1, wordlength <= MAX_WORDLENGTH
+ * Returns 1 on success 0 if p is not a valid modulus (which is not cached)
+ */
+int mont_cache_get(mont_cache_t * cache, mont_ctx_t * ctx, uint16_t * p, uint8_t wordlength);
+
+/**
+ * Number of lookups served from the cache and of lookups that ran mont_setup
+ */
+void mont_cache_stats(mont_cache_t * cache, uint64_t * hits, uint64_t * misses);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_MONT_CACHE_H */
+
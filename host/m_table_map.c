@@ -0,0 +1,77 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "m_table.h"
+#include "m_table_map.h"
+
+/**
+ * Maps a table file read-only and validates it with table_check
+ */
+const uint16_t * table_map(const char * path, uint32_t * size_words, int verify_payload, int * status) {
+    struct stat st;
+    void * map;
+    int fd;
+
+    *status = -1;
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (0 != fstat(fd, &st)) {
+        close(fd);
+        return NULL;
+    }
+    if ((st.st_size < 2 * M_TABLE_HEADER_WORDS) || (0 != (st.st_size & 1))
+            || (st.st_size / 2 > (off_t) UINT32_MAX)) {
+        *status = M_TABLE_ERR_SIZE;
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    //The mapping holds its own reference to the file
+    close(fd);
+    if (MAP_FAILED == map) {
+        return NULL;
+    }
+
+    *size_words = (uint32_t) (st.st_size / 2);
+    *status = table_check((const uint16_t *) map, *size_words, verify_payload);
+    if (M_TABLE_OK != *status) {
+        munmap(map, (size_t) st.st_size);
+        return NULL;
+    }
+    return (const uint16_t *) map;
+}
+
+/**
+ * Unmaps a table returned by table_map
+ */
+void table_unmap(const uint16_t * t, uint32_t size_words) {
+    munmap((void *) t, 2 * (size_t) size_words);
+}
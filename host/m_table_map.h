@@ -0,0 +1,38 @@
+/*
+ * File:   m_table_map.h
+ *
+ * Read-only memory mapping of fixed-base table files on POSIX hosts. The
+ * mapping is shared, so every process mapping the same file uses the same
+ * page cache copy and nothing is parsed or copied at startup.
+ */
+
+#ifndef M_TABLE_MAP_H
+#define	M_TABLE_MAP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+/**
+ * Maps a table file read-only and validates it with table_check
+ *
+ * @param path the table file, as written by mktable
+ * @param size_words set to the size of the table in words
+ * @param verify_payload non zero to also verify the payload checksum
+ * @param status set to M_TABLE_OK or an M_TABLE_ERR_ code, -1 on a system error
+ * @return the table, NULL on failure
+ */
+const uint16_t * table_map(const char * path, uint32_t * size_words, int verify_payload, int * status);
+
+/**
+ * Unmaps a table returned by table_map
+ */
+void table_unmap(const uint16_t * t, uint32_t size_words);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_TABLE_MAP_H */
+
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * mktable: writes the fixed-base table file for a generator g of Z*_{p_192}.
+ *
+ *   mktable [-w window] [-b bits] g_hex out_file
+ *
+ * g_hex is big-endian hex. The file is written to out_file.tmp and renamed,
+ * so processes mapping out_file never see a partial table. Build with e.g.
+ *
+ *   cc -O2 -I../iar -o mktable mktable.c m_table_map.c ../iar/m_table.c \
+ *       ../iar/m_conv.c ../iar/m_arith_p192.c ../iar/m_arith.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_conv.h"
+#include "m_table.h"
+#include "m_table_map.h"
+
+static int write_table(const char * path, const uint16_t * t, uint32_t size_words) {
+    char tmp[4096];
+    unsigned char buf[2];
+    uint32_t i;
+    FILE * f;
+
+    if (strlen(path) + 5 > sizeof(tmp)) {
+        return -1;
+    }
+    sprintf(tmp, "%s.tmp", path);
+    f = fopen(tmp, "wb");
+    if (NULL == f) {
+        return -1;
+    }
+    //The format is little-endian whatever the byte order of this host
+    for (i = 0; i < size_words; i++) {
+        buf[0] = (unsigned char) t[i];
+        buf[1] = (unsigned char) (t[i] >> 8);
+        if (2 != fwrite(buf, 1, 2, f)) {
+            fclose(f);
+            remove(tmp);
+            return -1;
+        }
+    }
+    if (0 != fclose(f)) {
+        remove(tmp);
+        return -1;
+    }
+    return rename(tmp, path);
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: mktable [-w window] [-b bits] g_hex out_file\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv) {
+    uint16_t g[WORDLENGTH];
+    uint16_t e[WORDLENGTH];
+    uint16_t A[WORDLENGTH];
+    uint16_t B[WORDLENGTH];
+    uint16_t window = 8;
+    uint16_t bits = 16 * WORDLENGTH;
+    uint16_t windows;
+    uint32_t size_words;
+    uint32_t mapped_words;
+    uint16_t * t;
+    const uint16_t * m;
+    int status;
+    int i = 1;
+
+    while ((i < argc) && ('-' == argv[i][0])) {
+        if ((0 == strcmp(argv[i], "-w")) && (i + 1 < argc)) {
+            window = (uint16_t) atoi(argv[++i]);
+        } else if ((0 == strcmp(argv[i], "-b")) && (i + 1 < argc)) {
+            bits = (uint16_t) atoi(argv[++i]);
+        } else {
+            usage();
+        }
+        i++;
+    }
+    if ((i + 2 != argc) || (0 == mp_from_hex(g, WORDLENGTH, argv[i], strlen(argv[i])))
+            || (mp_non_zero_words(g, WORDLENGTH) < 0)) {
+        usage();
+    }
+    if ((0 == window) || (window > M_TABLE_MAX_WINDOW) || (0 == bits) || (bits > 16 * WORDLENGTH)) {
+        fprintf(stderr, "mktable: window must be in 1..%d and bits in 1..%d\n",
+                M_TABLE_MAX_WINDOW, 16 * WORDLENGTH);
+        return 2;
+    }
+
+    windows = (bits + window - 1) / window;
+    size_words = table_size_words(WORDLENGTH, window, windows);
+    t = (uint16_t *) malloc(2 * (size_t) size_words);
+    if (NULL == t) {
+        fprintf(stderr, "mktable: out of memory\n");
+        return 1;
+    }
+    status = table_build_p_192(t, size_words, g, window, bits);
+    if ((M_TABLE_OK != status) || (0 != write_table(argv[i + 1], t, size_words))) {
+        fprintf(stderr, "mktable: cannot write %s (%d)\n", argv[i + 1], status);
+        free(t);
+        return 1;
+    }
+    free(t);
+
+    //Read the file back the way the library users will and spot check it
+    m = table_map(argv[i + 1], &mapped_words, 1, &status);
+    if (NULL == m) {
+        fprintf(stderr, "mktable: %s does not validate (%d)\n", argv[i + 1], status);
+        return 1;
+    }
+    set_to_zero(e, WORDLENGTH);
+    for (i = 0; i < bits; i++) {
+        e[i / 16] |= (uint16_t) (1 << (i % 16));
+    }
+    mod_exp_p_192_fb(A, m, e, WORDLENGTH);
+    mod_exp_p_192(B, g, e, WORDLENGTH);
+    table_unmap(m, mapped_words);
+    if (0 == are_mp_equal(A, B, WORDLENGTH)) {
+        fprintf(stderr, "mktable: table does not match mod_exp_p_192\n");
+        return 1;
+    }
+    printf("%lu bytes, window %u, %u windows\n", 2 * (unsigned long) size_words, window, windows);
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * mont_cache_stress: threads looking up random moduli through a small
+ * mont_cache, so that installs keep replacing entries under the lock-free
+ * readers. Every context returned is compared with one from mont_setup.
+ *
+ *   mont_cache_stress [threads] [lookups_per_thread]
+ *
+ * Exits 0 if every lookup returned the right context. Build it under
+ * ThreadSanitizer and under AddressSanitizer with e.g.
+ *
+ *   cc -std=c11 -O1 -g -fsanitize=thread -I../iar -o mont_cache_stress \
+ *       mont_cache_stress.c m_mont_cache.c ../iar/m_arith_mont.c \
+ *       ../iar/m_gcd.c ../iar/m_arith.c -lpthread
+ *   cc -std=c11 -O1 -g -fsanitize=address,undefined -I../iar ...
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_mont.h"
+#include "m_mont_cache.h"
+
+#define MODULI      300
+#define CAPACITY    64
+#define MAX_THREADS 64
+
+typedef struct {
+    unsigned int seed;
+    long lookups;
+} stress_arg_t;
+
+static uint16_t moduli[MODULI][MAX_WORDLENGTH];
+static uint8_t wordlengths[MODULI];
+static mont_ctx_t expected[MODULI];
+static mont_cache_t * cache;
+static atomic_long errors;
+
+static unsigned int next_random(unsigned int * s) {
+    *s = *s * 1103515245U + 12345U;
+    return *s >> 8;
+}
+
+static int same_ctx(mont_ctx_t * a, mont_ctx_t * b) {
+    int t = b->wordlength;
+
+    return (a->wordlength == b->wordlength) && (a->p_prime == b->p_prime)
+            && (1 == are_mp_equal(a->p, b->p, t)) && (1 == are_mp_equal(a->r2, b->r2, t))
+            && (1 == are_mp_equal(a->one, b->one, t));
+}
+
+static void * lookup_stage(void * arg) {
+    stress_arg_t * s = (stress_arg_t *) arg;
+    mont_ctx_t ctx;
+    long n;
+    int k;
+
+    for (n = 0; n < s->lookups; n++) {
+        k = (int) (next_random(&s->seed) % MODULI);
+        if ((1 != mont_cache_get(cache, &ctx, moduli[k], wordlengths[k])) || (0 == same_ctx(&ctx, &expected[k]))) {
+            atomic_fetch_add(&errors, 1);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char ** argv) {
+    pthread_t threads[MAX_THREADS];
+    stress_arg_t args[MAX_THREADS];
+    unsigned int seed = 1;
+    uint64_t hits, misses;
+    long lookups = 50000;
+    int n_threads = 8;
+    int started, i, j;
+
+    if (argc > 1) {
+        n_threads = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        lookups = atol(argv[2]);
+    }
+    if ((n_threads < 1) || (n_threads > MAX_THREADS) || (lookups < 1)) {
+        fprintf(stderr, "usage: mont_cache_stress [threads] [lookups_per_thread]\n");
+        return 2;
+    }
+
+    //1. Random odd moduli of random lengths, the top word non-zero
+    for (i = 0; i < MODULI; i++) {
+        wordlengths[i] = (uint8_t) (1 + next_random(&seed) % MAX_WORDLENGTH);
+        for (j = 0; j < wordlengths[i]; j++) {
+            moduli[i][j] = (uint16_t) next_random(&seed);
+        }
+        moduli[i][0] |= 1;
+        moduli[i][wordlengths[i] - 1] |= 0x8000;
+        mont_setup(&expected[i], moduli[i], wordlengths[i]);
+    }
+    cache = mont_cache_create(CAPACITY);
+    if (NULL == cache) {
+        fprintf(stderr, "mont_cache_stress: cannot create the cache\n");
+        return 1;
+    }
+    atomic_init(&errors, 0);
+
+    //2. The threads share the cache, which holds fewer moduli than they use
+    for (started = 0; started < n_threads; started++) {
+        args[started].seed = (unsigned int) started + 1;
+        args[started].lookups = lookups;
+        if (0 != pthread_create(&threads[started], NULL, lookup_stage, &args[started])) {
+            fprintf(stderr, "mont_cache_stress: cannot start the threads\n");
+            atomic_fetch_add(&errors, 1);
+            break;
+        }
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    mont_cache_stats(cache, &hits, &misses);
+    mont_cache_destroy(cache);
+    printf("%d threads, %lu hits, %lu misses, %ld errors\n", started,
+            (unsigned long) hits, (unsigned long) misses, atomic_load(&errors));
+    return (0 == atomic_load(&errors)) ? 0 : 1;
+}
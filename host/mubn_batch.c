@@ -0,0 +1,463 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*
+ * mubn_batch: recomputes mod_exp_p_192 or multiply_mod_p_192 over an
+ * operand file.
+ *
+ *   mubn_batch [-x] [-t threads] [-q slots] {exp|mul} in_file out_file
+ *
+ * Each input record is a pair (a, b) and the result is a^b or a*b mod p_192.
+ * Binary records are two 12-word elements in the limb format (24 bytes each,
+ * little-endian words, least significant word first) and results are one
+ * element. With -x every line holds a and b as big-endian hex and every
+ * result is written as a line of 48 hex digits. out_file may be - for stdout.
+ *
+ * The input is memory mapped and flows through a ring of batch slots: one
+ * thread parses, the workers compute and one thread serializes in input
+ * order, so the stages overlap and memory stays bounded by the ring. Build
+ * with e.g.
+ *
+ *   cc -O2 -mssse3 -I../iar -o mubn_batch mubn_batch.c ../iar/m_conv.c \
+ *       ../iar/m_arith_p192.c ../iar/m_arith.c -lpthread
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_conv.h"
+
+#define BATCH_RECORDS   512
+#define RECORD_BYTES    (2 * 2 * WORDLENGTH)
+#define RESULT_BYTES    (2 * WORDLENGTH)
+
+#define SLOT_FREE       0
+#define SLOT_PARSED     1
+#define SLOT_DONE       2
+
+typedef struct {
+    int state;
+    int n;
+    uint16_t a[BATCH_RECORDS][WORDLENGTH];
+    uint16_t b[BATCH_RECORDS][WORDLENGTH];
+    uint16_t r[BATCH_RECORDS][WORDLENGTH];
+} batch_t;
+
+typedef struct {
+    //Input
+    const unsigned char * in;
+    size_t in_len;
+    size_t in_pos;
+    unsigned long line;
+    int hex;
+    int op_exp;
+    FILE * out;
+
+    //The ring
+    batch_t * slots;
+    int n_slots;
+    long parsed;        // batches handed to the workers
+    long next_compute;  // next batch a worker picks up
+    int parse_done;
+    int failed;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} batch_job_t;
+
+static uint16_t p_192[WORDLENGTH] = {0xffff, 0xffff, 0xffff, 0xffff, 0xfffe, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+
+/*
+ * Blanks of a hex line, around and between its fields
+ */
+static int is_blank(unsigned char c) {
+    return (' ' == c) || ('\t' == c) || ('\r' == c);
+}
+
+/*
+ * Parses one big-endian hex number at the current position, skipping blanks
+ */
+static int parse_hex_field(batch_job_t * job, uint16_t * out) {
+    size_t start;
+    unsigned char c;
+
+    while ((job->in_pos < job->in_len) && (0 != is_blank(job->in[job->in_pos]))) {
+        job->in_pos++;
+    }
+    start = job->in_pos;
+    while (job->in_pos < job->in_len) {
+        c = job->in[job->in_pos];
+        if ((0 != is_blank(c)) || ('\n' == c)) {
+            break;
+        }
+        job->in_pos++;
+    }
+    if ((start == job->in_pos)
+            || (0 == mp_from_hex(out, WORDLENGTH, (const char *) job->in + start, job->in_pos - start))) {
+        return -1;
+    }
+    return 0;
+}
+
+static void read_words(uint16_t * out, const unsigned char * in) {
+    int i;
+
+    for (i = 0; i < WORDLENGTH; i++) {
+        out[i] = (uint16_t) (in[2 * i] | (in[2 * i + 1] << 8));
+    }
+}
+
+/*
+ * Fills a batch from the input, returns -1 on a malformed record
+ */
+static int parse_batch(batch_job_t * job, batch_t * batch) {
+    batch->n = 0;
+    while ((batch->n < BATCH_RECORDS) && (job->in_pos < job->in_len)) {
+        if (0 != job->hex) {
+            job->line++;
+            //Blank line, a trailing '\r' is stripped first
+            if (('\r' == job->in[job->in_pos])
+                    && ((job->in_pos + 1 == job->in_len) || ('\n' == job->in[job->in_pos + 1]))) {
+                job->in_pos++;
+            }
+            if (job->in_pos == job->in_len) {
+                continue;
+            }
+            if ('\n' == job->in[job->in_pos]) {
+                job->in_pos++;
+                continue;
+            }
+            if ((0 != parse_hex_field(job, batch->a[batch->n])) || (0 != parse_hex_field(job, batch->b[batch->n]))) {
+                return -1;
+            }
+            while ((job->in_pos < job->in_len) && (0 != is_blank(job->in[job->in_pos]))) {
+                job->in_pos++;
+            }
+            if (job->in_pos < job->in_len) {
+                if ('\n' != job->in[job->in_pos]) {
+                    return -1;
+                }
+                job->in_pos++;
+            }
+        } else {
+            if (job->in_len - job->in_pos < RECORD_BYTES) {
+                return -1;
+            }
+            read_words(batch->a[batch->n], job->in + job->in_pos);
+            read_words(batch->b[batch->n], job->in + job->in_pos + RESULT_BYTES);
+            job->in_pos += RECORD_BYTES;
+            job->line++;
+        }
+        //Operands of multiply_mod_p_192 and bases of mod_exp_p_192 are in [0,p-1]
+        if ((1 == compare_mp_elements(batch->a[batch->n], p_192, WORDLENGTH))
+                || ((0 == job->op_exp) && (1 == compare_mp_elements(batch->b[batch->n], p_192, WORDLENGTH)))) {
+            return -1;
+        }
+        batch->n++;
+    }
+    return 0;
+}
+
+static void * parse_stage(void * arg) {
+    batch_job_t * job = (batch_job_t *) arg;
+    batch_t * batch;
+    long seq;
+    int failed;
+
+    for (seq = 0; job->in_pos < job->in_len; seq++) {
+        batch = &job->slots[seq % job->n_slots];
+        pthread_mutex_lock(&job->lock);
+        while ((SLOT_FREE != batch->state) && (0 == job->failed)) {
+            pthread_cond_wait(&job->cond, &job->lock);
+        }
+        failed = job->failed;
+        pthread_mutex_unlock(&job->lock);
+        if (0 != failed) {
+            break;
+        }
+
+        if (0 != parse_batch(job, batch)) {
+            fprintf(stderr, "mubn_batch: malformed %s %lu\n", (0 != job->hex) ? "line" : "record", job->line);
+            pthread_mutex_lock(&job->lock);
+            job->failed = 1;
+            pthread_cond_broadcast(&job->cond);
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+        if (0 == batch->n) {
+            break;
+        }
+        pthread_mutex_lock(&job->lock);
+        batch->state = SLOT_PARSED;
+        job->parsed = seq + 1;
+        pthread_cond_broadcast(&job->cond);
+        pthread_mutex_unlock(&job->lock);
+    }
+
+    pthread_mutex_lock(&job->lock);
+    job->parse_done = 1;
+    pthread_cond_broadcast(&job->cond);
+    pthread_mutex_unlock(&job->lock);
+    return NULL;
+}
+
+static void * compute_stage(void * arg) {
+    batch_job_t * job = (batch_job_t *) arg;
+    batch_t * batch;
+    long seq;
+    int i;
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        while ((job->next_compute == job->parsed) && (0 == job->parse_done) && (0 == job->failed)) {
+            pthread_cond_wait(&job->cond, &job->lock);
+        }
+        if ((0 != job->failed) || (job->next_compute == job->parsed)) {
+            pthread_mutex_unlock(&job->lock);
+            return NULL;
+        }
+        seq = job->next_compute++;
+        pthread_mutex_unlock(&job->lock);
+
+        batch = &job->slots[seq % job->n_slots];
+        for (i = 0; i < batch->n; i++) {
+            if (0 != job->op_exp) {
+                if (mp_non_zero_words(batch->b[i], WORDLENGTH) < 0) {
+                    set_to_zero(batch->r[i], WORDLENGTH);
+                    batch->r[i][0] = 1;
+                } else {
+                    mod_exp_p_192(batch->r[i], batch->a[i], batch->b[i], WORDLENGTH);
+                }
+            } else {
+                multiply_mod_p_192(batch->r[i], batch->a[i], batch->b[i]);
+            }
+        }
+
+        pthread_mutex_lock(&job->lock);
+        batch->state = SLOT_DONE;
+        pthread_cond_broadcast(&job->cond);
+        pthread_mutex_unlock(&job->lock);
+    }
+}
+
+static int write_batch(batch_job_t * job, batch_t * batch) {
+    char buf[4 * WORDLENGTH + 1];
+    int i, w, len;
+
+    for (i = 0; i < batch->n; i++) {
+        if (0 != job->hex) {
+            mp_to_hex(buf, batch->r[i], WORDLENGTH);
+            buf[4 * WORDLENGTH] = '\n';
+            len = 4 * WORDLENGTH + 1;
+        } else {
+            for (w = 0; w < WORDLENGTH; w++) {
+                buf[2 * w] = (char) batch->r[i][w];
+                buf[2 * w + 1] = (char) (batch->r[i][w] >> 8);
+            }
+            len = RESULT_BYTES;
+        }
+        if ((size_t) len != fwrite(buf, 1, (size_t) len, job->out)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * The serialize stage runs on the main thread, in input order
+ */
+static long serialize_stage(batch_job_t * job) {
+    batch_t * batch;
+    long records = 0;
+    long seq;
+
+    for (seq = 0;; seq++) {
+        batch = &job->slots[seq % job->n_slots];
+        pthread_mutex_lock(&job->lock);
+        while ((SLOT_DONE != batch->state) && (0 == job->failed)
+                && ((0 == job->parse_done) || (seq < job->parsed))) {
+            pthread_cond_wait(&job->cond, &job->lock);
+        }
+        if ((0 != job->failed) || (SLOT_DONE != batch->state)) {
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+        pthread_mutex_unlock(&job->lock);
+
+        if (0 != write_batch(job, batch)) {
+            fprintf(stderr, "mubn_batch: write error\n");
+            pthread_mutex_lock(&job->lock);
+            job->failed = 1;
+            pthread_cond_broadcast(&job->cond);
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+        records += batch->n;
+
+        pthread_mutex_lock(&job->lock);
+        batch->state = SLOT_FREE;
+        pthread_cond_broadcast(&job->cond);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return records;
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: mubn_batch [-x] [-t threads] [-q slots] {exp|mul} in_file out_file\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv) {
+    batch_job_t job;
+    pthread_t parser;
+    pthread_t * workers;
+    struct timespec start, end;
+    struct stat st;
+    void * map = NULL;
+    double seconds;
+    long records;
+    long threads;
+    long started = 0;
+    int parser_started;
+    int fd;
+    int i = 1;
+
+    memset(&job, 0, sizeof(job));
+    threads = sysconf(_SC_NPROCESSORS_ONLN);
+    job.n_slots = 0;
+    while ((i < argc) && ('-' == argv[i][0]) && ('\0' != argv[i][1])) {
+        if (0 == strcmp(argv[i], "-x")) {
+            job.hex = 1;
+        } else if ((0 == strcmp(argv[i], "-t")) && (i + 1 < argc)) {
+            threads = atol(argv[++i]);
+        } else if ((0 == strcmp(argv[i], "-q")) && (i + 1 < argc)) {
+            job.n_slots = atoi(argv[++i]);
+        } else {
+            usage();
+        }
+        i++;
+    }
+    if (i + 3 != argc) {
+        usage();
+    }
+    if (0 == strcmp(argv[i], "exp")) {
+        job.op_exp = 1;
+    } else if (0 != strcmp(argv[i], "mul")) {
+        usage();
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (job.n_slots < 1) {
+        //Enough for every worker to hold one batch while the ends hold theirs
+        job.n_slots = (int) threads + 2;
+    }
+
+    fd = open(argv[i + 1], O_RDONLY);
+    if ((fd < 0) || (0 != fstat(fd, &st))) {
+        perror(argv[i + 1]);
+        return 1;
+    }
+    if (st.st_size > 0) {
+        map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == map) {
+            perror(argv[i + 1]);
+            return 1;
+        }
+        posix_madvise(map, (size_t) st.st_size, POSIX_MADV_SEQUENTIAL);
+    }
+    close(fd);
+    job.in = (const unsigned char *) map;
+    job.in_len = (size_t) st.st_size;
+
+    if (0 == strcmp(argv[i + 2], "-")) {
+        job.out = stdout;
+    } else {
+        job.out = fopen(argv[i + 2], "wb");
+    }
+    job.slots = (batch_t *) calloc((size_t) job.n_slots, sizeof(batch_t));
+    workers = (pthread_t *) calloc((size_t) threads, sizeof(pthread_t));
+    if ((NULL == job.out) || (NULL == job.slots) || (NULL == workers)) {
+        fprintf(stderr, "mubn_batch: cannot set up %s\n", argv[i + 2]);
+        return 1;
+    }
+    setvbuf(job.out, NULL, _IOFBF, 1 << 20);
+    if (0 != pthread_mutex_init(&job.lock, NULL)) {
+        fprintf(stderr, "mubn_batch: cannot set up the pipeline\n");
+        return 1;
+    }
+    if (0 != pthread_cond_init(&job.cond, NULL)) {
+        fprintf(stderr, "mubn_batch: cannot set up the pipeline\n");
+        pthread_mutex_destroy(&job.lock);
+        return 1;
+    }
+
+    //A stage that does not start fails the job, the ones that did stop on it
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    parser_started = (0 == pthread_create(&parser, NULL, parse_stage, &job));
+    while ((0 != parser_started) && (started < threads)
+            && (0 == pthread_create(&workers[started], NULL, compute_stage, &job))) {
+        started++;
+    }
+    if (started < threads) {
+        fprintf(stderr, "mubn_batch: cannot start the threads\n");
+        pthread_mutex_lock(&job.lock);
+        job.failed = 1;
+        pthread_cond_broadcast(&job.cond);
+        pthread_mutex_unlock(&job.lock);
+    }
+    records = serialize_stage(&job);
+    if (0 != parser_started) {
+        pthread_join(parser, NULL);
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    if ((0 != fflush(job.out)) || ((stdout != job.out) && (0 != fclose(job.out)))) {
+        fprintf(stderr, "mubn_batch: write error\n");
+        job.failed = 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    seconds = (double) (end.tv_sec - start.tv_sec) + 1e-9 * (double) (end.tv_nsec - start.tv_nsec);
+    fprintf(stderr, "%ld records in %.3f s, %.0f records/s, %ld worker threads\n",
+            records, seconds, (seconds > 0) ? records / seconds : 0.0, threads);
+
+    if (NULL != map) {
+        munmap(map, job.in_len);
+    }
+    pthread_cond_destroy(&job.cond);
+    pthread_mutex_destroy(&job.lock);
+    free(workers);
+    free(job.slots);
+    return (0 != job.failed) ? 1 : 0;
+}
@@ -25,6 +25,7 @@
 //#include "msp430setup.h"
 #include <signal.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "m_defs.h"
@@ -39,13 +40,12 @@
  */
 uint16_t add_word(uint16_t * c_i, uint16_t a_i, uint16_t b_i, uint16_t epsilon_prime) {
     uint16_t epsilon; //The carry bit
-    *c_i = (a_i + b_i + epsilon_prime);
+    uint32_t sum;
 
-    if ((*c_i >= (a_i + epsilon_prime)) && (*c_i >= b_i)) {
-        epsilon = 0;
-    } else {
-        epsilon = 1;
-    }
+    //Work on 32 bits, the MSP430 int is only 16 bits wide and a_i + epsilon_prime may wrap
+    sum = ((uint32_t) a_i) + ((uint32_t) b_i) + ((uint32_t) epsilon_prime);
+    *c_i = (uint16_t) sum;
+    epsilon = (uint16_t) (sum >> 16);
     return epsilon;
 }
 
@@ -54,16 +54,12 @@ uint16_t add_word(uint16_t * c_i, uint16_t a_i, uint16_t b_i, uint16_t epsilon_p
  * c_i = (a_1 - b_i - epsilon_prime) mod 0xFFFF
  */
 uint8_t subtract_word(uint16_t * c_i, uint16_t a_i, uint16_t b_i, uint8_t epsilon_prime) {
-    uint8_t epsilon; //The carry bit
+    uint8_t epsilon; //The borrow bit
     *c_i = (a_i - b_i - epsilon_prime);
-    if (0xFFFF == b_i) {
+    if ((a_i < b_i) || ((a_i == b_i) && (1 == epsilon_prime))) {
         epsilon = 1;
     } else {
-        if (a_i < b_i) {
-            epsilon = 1;
-        } else {
-            epsilon = 0;
-        }
+        epsilon = 0;
     }
 
     return epsilon;
@@ -150,7 +146,7 @@ void subtract_mod_p(uint16_t * c, uint16_t * a, uint16_t * b, uint16_t * p, uint
 /**
  * Sets a bn to zero
  */
-void set_to_zero(uint16_t * c, uint8_t wordlength) {
+void set_to_zero(uint16_t * c, uint16_t wordlength) {
     int i;
     for (i = 0; i < wordlength; i++) {
         c[i] = 0x0000;
@@ -222,64 +218,44 @@ void multiply_words_2(uint16_t a, uint16_t b, uint16_t * uv) {
 /**
  * Multiprecision Multiplication c.f. Alg. 2.9
  * Input: a, b \in [0,p-1]
- * Output: c = a*b
+ * Output: c = a*b, c must not overlap a or b
  */
-void multiply_mp_elements(uint16_t * c, uint16_t * a, uint16_t * b, uint8_t wordlength) {
-    uint16_t UV[2];
-    uint16_t temp1[2];
-    uint16_t temp2[2];
-
+void multiply_mp_elements(uint16_t * M_RESTRICT c, uint16_t * a, uint16_t * b, uint8_t wordlength) {
+    uint32_t UV;
     int i, j;
+
     //1. Set c[i] = 0 for 0 \leq i \leq wordlength-1
-    set_to_zero(c, 2 * wordlength);
-    //2.
-    set_to_zero(UV, 2);
+    set_to_zero(c, wordlength);
+    //2. UV = c[i+j] + a[i]*b[j] + U fits in 32 bits
     for (i = 0; i < wordlength; i++) {
-        UV[1] = 0;
+        UV = 0;
         for (j = 0; j < wordlength; j++) {
-            //UV = c[i+j] + a[i]*b[j] + UV[0];
-            temp2[0] = UV[1];
-            temp2[1] = 0x0000;
-            multiply_words(a[i], b[j], UV);
-            temp1[0] = c[i + j];
-            temp1[1] = 0x0000;
-            add_mp_elements(UV, UV, temp1, 2);
-            add_mp_elements(UV, UV, temp2, 2);
-            c[i + j] = UV[0];
+            UV = ((uint32_t) a[i]) * ((uint32_t) b[j]) + ((uint32_t) c[i + j]) + (UV >> 16);
+            c[i + j] = (uint16_t) UV;
         }
-        c[i + wordlength] = UV[1];
+        c[i + wordlength] = (uint16_t) (UV >> 16);
     }
 }
 
 /**
  * Multiprecision Multiplication c.f. Alg. 2.9
  * Input: a, b \in [0,p-1]
- * Output: c = a*b
+ * Output: c = a*b of wordlength_a + wordlength_b words, c must not overlap a or b
  */
-void multiply_mp_elements2(uint16_t * c, uint16_t * a, uint8_t wordlength_a, uint16_t * b, uint8_t wordlength_b) {
-    uint16_t UV[2];
-    uint16_t temp1[2];
-    uint16_t temp2[2];
-
+void multiply_mp_elements2(uint16_t * M_RESTRICT c, uint16_t * a, uint8_t wordlength_a, uint16_t * b, uint8_t wordlength_b) {
+    uint32_t UV;
     int i, j;
-    //1. Set c[i] = 0 for 0 \leq i \leq wordlength-1
-    set_to_zero(c, wordlength_a + wordlength_b);
+
+    //1. Set c[i] = 0 for 0 \leq i \leq wordlength_b-1
+    set_to_zero(c, wordlength_b);
     //2.
-    set_to_zero(UV, 2);
-    for (i = 0; i < wordlength_b; i++) {
-        UV[1] = 0;
-        for (j = 0; j < wordlength_a; j++) {
-            //UV = c[i+j] + a[i]*b[j] + UV[0];
-            temp2[0] = UV[1];
-            temp2[1] = 0x0000;
-            multiply_words(a[i], b[j], UV);
-            temp1[0] = c[i + j];
-            temp1[1] = 0x0000;
-            add_mp_elements(UV, UV, temp1, 2);
-            add_mp_elements(UV, UV, temp2, 2);
-            c[i + j] = UV[0];
+    for (i = 0; i < wordlength_a; i++) {
+        UV = 0;
+        for (j = 0; j < wordlength_b; j++) {
+            UV = ((uint32_t) a[i]) * ((uint32_t) b[j]) + ((uint32_t) c[i + j]) + (UV >> 16);
+            c[i + j] = (uint16_t) UV;
         }
-        c[i + wordlength_b] = UV[1];
+        c[i + wordlength_b] = (uint16_t) (UV >> 16);
     }
 }
 
@@ -289,7 +265,7 @@ void multiply_mp_elements2(uint16_t * c, uint16_t * a, uint8_t wordlength_a, uin
  * Compares two big nums
  * Returns 1 if a >= b 0 otherwise
  */
-uint8_t compare_mp_elements(uint16_t * a, uint16_t * b, uint8_t wordlength) {
+uint8_t compare_mp_elements(uint16_t * a, uint16_t * b, uint16_t wordlength) {
     int i;
 
     for (i = wordlength-1; i > -1; i--) {
@@ -316,24 +292,24 @@ uint8_t compare_mp_elements(uint16_t * a, uint16_t * b, uint8_t wordlength) {
  */
 void mult_by_power_of_b(uint16_t * out, uint16_t wordlength_out, uint16_t * a,
         uint16_t wordlength_a, uint16_t k) {
-    int i = 0;
-    //initialize out
-    set_to_zero(out, wordlength_out);
+    int i;
 
-    while(i + k < wordlength_out) {
-        if(i<wordlength_a) {
-            out[i+k] = a[i];
+    //From the top down, so that out may be a
+    for (i = wordlength_out - 1; i >= 0; i--) {
+        if ((i >= k) && (i - k < wordlength_a)) {
+            out[i] = a[i - k];
+        } else {
+            out[i] = 0;
         }
-        i++;
     }
 }
 
 void mod_pow_of_b(uint16_t * out, uint16_t wordlength_out, uint16_t * a,
         uint16_t wordlength_a, uint16_t k){
-    int i;
+    int i = 0;
 
     while(i < wordlength_out) {
-        if(i < wordlength_a) {
+        if((i < wordlength_a) && (i < k)) {
             out[i] = a[i];
         }
         else {
@@ -349,11 +325,13 @@ Divide by a power of b
 void div_by_power_of_b(uint16_t * out, uint16_t * a, uint16_t k,
         uint16_t wordlength) {
     int i;
-    //initialize z_div
-    set_to_zero(out, wordlength);
-    if (k < wordlength) {
-        for (i = k; i < wordlength; i++) {
-            out[i - k] = a[i];
+
+    //From the bottom up, so that out may be a
+    for (i = 0; i < wordlength; i++) {
+        if (i + k < wordlength) {
+            out[i] = a[i + k];
+        } else {
+            out[i] = 0;
         }
     }
 }
@@ -372,9 +350,8 @@ void multiply_sp_by_mp_element(uint16_t * c, uint16_t a, uint16_t * b,
     uint16_t carry;
 
     int j;
-    //1. Set c[i] = 0 for 0 \leq i \leq wordlength-1
-    set_to_zero(c, wordlength_b + 1);
-    //2. Perform paper and pencil multiplication
+    //1. Perform paper and pencil multiplication, every word of c is written
+    //after the word of b it depends on, so that c may be b
     uv = 0;
     carry = 0;
     for (j = 0; j < wordlength_b; j++) {
@@ -387,7 +364,25 @@ void multiply_sp_by_mp_element(uint16_t * c, uint16_t a, uint16_t * b,
     c[wordlength_b] = carry;
 }
 
-int are_mp_equal(uint16_t * a, uint16_t * b, uint8_t wordlength){
+/**
+ * Remainder of a BigNum by a single word
+ * @param a A BigNum of size wordlength in 16-bit words.
+ * @param d A non zero 16-bit divisor
+ * @return a mod d
+ */
+uint16_t mp_mod_sp(uint16_t * a, uint16_t wordlength, uint16_t d) {
+    uint32_t r;
+    int i;
+
+    //Paper and pencil division from the most significant word, r < d throughout
+    r = 0;
+    for (i = wordlength - 1; i >= 0; i--) {
+        r = ((r << 16) | ((uint32_t) a[i])) % ((uint32_t) d);
+    }
+    return (uint16_t) r;
+}
+
+int are_mp_equal(uint16_t * a, uint16_t * b, uint16_t wordlength){
     int i =0;
     int answ = 1;
 
@@ -460,6 +455,28 @@ int mp_ith_bit(uint16_t * e, int i){
     return word_bit;
 }
 
+/**
+ * Returns the k-bit window of e starting at bit i, i.e. (e >> i) mod 2^k.
+ * Bits beyond the wordlength of e read as zero. k must be at most 16.
+ */
+uint16_t mp_bits(uint16_t * e, uint16_t wordlength, int i, int k){
+    uint32_t window;
+    int word;
+    int offset;
+
+    word = i / 16;
+    offset = i - word * 16;
+    if (word >= wordlength) {
+        return 0;
+    }
+    window = (uint32_t) e[word];
+    if ((offset + k > 16) && (word + 1 < wordlength)) {
+        window |= ((uint32_t) e[word + 1]) << 16;
+    }
+    window >>= offset;
+    return (uint16_t) (window & ((((uint32_t) 1) << k) - 1));
+}
+
 int mp_non_zero_words(uint16_t * e, uint16_t wordlength){
     int i = wordlength - 1;
     int last_non_zero_word = -1;
@@ -473,15 +490,126 @@ int mp_non_zero_words(uint16_t * e, uint16_t wordlength){
     return last_non_zero_word;
 }
 
+/**
+ * Multiprecision division c.f. Knuth TAOCP Vol. 2 Alg. 4.3.1 D
+ * Input: a of wordlength_a <= 2*MAX_WORDLENGTH words, b != 0 of
+ * wordlength_b <= MAX_WORDLENGTH words
+ * Output: q = a div b (wordlength_a words, may be NULL) and r = a mod b
+ * (wordlength_b words, may be NULL). r may be a or b, q must not overlap
+ * a or b
+ * Returns 1 on success 0 if b = 0 or the lengths are out of range
+ */
+int divide_mp_elements(uint16_t * M_RESTRICT q, uint16_t * r, uint16_t * a, uint16_t wordlength_a,
+        uint16_t * b, uint16_t wordlength_b) {
+    uint16_t u[2 * MAX_WORDLENGTH + 1];
+    uint16_t v[MAX_WORDLENGTH];
+    uint32_t qhat, rhat, p, t, carry, borrow;
+    int m, n, s, i, j;
+
+    n = mp_non_zero_words(b, wordlength_b) + 1;
+    m = mp_non_zero_words(a, wordlength_a) + 1;
+    if ((0 == n) || (wordlength_a > 2 * MAX_WORDLENGTH) || (wordlength_b > MAX_WORDLENGTH)) {
+        return 0;
+    }
+    if (NULL != q) {
+        set_to_zero(q, wordlength_a);
+    }
+    //1. a < b
+    if (m < n) {
+        if (NULL != r) {
+            copy_mp(r, a, m);
+            set_to_zero(r + m, wordlength_b - m);
+        }
+        return 1;
+    }
+    //2. Single word divisor
+    if (1 == n) {
+        t = 0;
+        for (j = m - 1; j >= 0; j--) {
+            t = (t << 16) | ((uint32_t) a[j]);
+            if (NULL != q) {
+                q[j] = (uint16_t) (t / b[0]);
+            }
+            t = t % b[0];
+        }
+        if (NULL != r) {
+            set_to_zero(r, wordlength_b);
+            r[0] = (uint16_t) t;
+        }
+        return 1;
+    }
+
+    //3. Normalize so that the top bit of the divisor is set
+    s = 15 - bit_length(b[n - 1]);
+    for (i = n - 1; i > 0; i--) {
+        v[i] = (uint16_t) ((((uint32_t) b[i]) << s) | (((uint32_t) b[i - 1]) >> (16 - s)));
+    }
+    v[0] = (uint16_t) (((uint32_t) b[0]) << s);
+    u[m] = (uint16_t) (((uint32_t) a[m - 1]) >> (16 - s));
+    for (i = m - 1; i > 0; i--) {
+        u[i] = (uint16_t) ((((uint32_t) a[i]) << s) | (((uint32_t) a[i - 1]) >> (16 - s)));
+    }
+    u[0] = (uint16_t) (((uint32_t) a[0]) << s);
+
+    //4. One quotient word per step
+    for (j = m - n; j >= 0; j--) {
+        //4.1 Estimate, at most one too large after the correction loop
+        t = (((uint32_t) u[j + n]) << 16) | ((uint32_t) u[j + n - 1]);
+        qhat = t / v[n - 1];
+        rhat = t % v[n - 1];
+        while ((qhat > 0xFFFF) || (qhat * v[n - 2] > ((rhat << 16) | u[j + n - 2]))) {
+            qhat--;
+            rhat += v[n - 1];
+            if (rhat > 0xFFFF) {
+                break;
+            }
+        }
+        //4.2 u = u - qhat*v*W^j
+        carry = 0;
+        borrow = 0;
+        for (i = 0; i < n; i++) {
+            p = qhat * v[i] + carry;
+            carry = p >> 16;
+            t = ((uint32_t) u[i + j]) - (p & 0xFFFF) - borrow;
+            u[i + j] = (uint16_t) t;
+            borrow = (t > 0xFFFF) ? 1 : 0;
+        }
+        t = ((uint32_t) u[j + n]) - carry - borrow;
+        u[j + n] = (uint16_t) t;
+        //4.3 Add back if the estimate was one too large
+        if (t > 0xFFFF) {
+            qhat--;
+            carry = 0;
+            for (i = 0; i < n; i++) {
+                t = ((uint32_t) u[i + j]) + ((uint32_t) v[i]) + carry;
+                u[i + j] = (uint16_t) t;
+                carry = t >> 16;
+            }
+            u[j + n] = (uint16_t) (u[j + n] + carry);
+        }
+        if (NULL != q) {
+            q[j] = (uint16_t) qhat;
+        }
+    }
+
+    //5. Unnormalize the remainder
+    if (NULL != r) {
+        set_to_zero(r, wordlength_b);
+        for (i = 0; i < n; i++) {
+            r[i] = (uint16_t) ((((uint32_t) u[i]) >> s) | (((uint32_t) u[i + 1]) << (16 - s)));
+        }
+    }
+    return 1;
+}
+
 /**
  * Multiplication in F_p
- * Input: a, b \in [0,p-1)
+ * Input: a, b \in [0,p-1), wordlength <= MAX_WORDLENGTH
  * Output: c = a * b mod p
  */
-//void multiply_mod_p(uint16_t * c, uint16_t * a, uint16_t * b, uint16_t * p, uint8_t wordlength){
-//    uint16_t ab[2*wordlength];
-//    uint16_t q[wordlength];
+void multiply_mod_p(uint16_t * c, uint16_t * a, uint16_t * b, uint16_t * p, uint16_t wordlength){
+    uint16_t ab[2 * MAX_WORDLENGTH];
 
-//    multiply_mp_elements(ab, a, b, wordlength);
-//    divide_mp_elements3(q, c, ab, 2*wordlength, p, wordlength);
-//}
\ No newline at end of file
+    multiply_mp_elements(ab, a, b, wordlength);
+    divide_mp_elements(NULL, c, ab, 2 * wordlength, p, wordlength);
+}
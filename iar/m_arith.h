@@ -13,9 +13,12 @@ extern "C" {
 #endif
 #include <stdint.h>
 
+#include "m_defs.h"
 
 // A big number will be stored as an array A of WORDLENGTH  WORDSIZE-words where A[0] is the
 //least significant bit.
+// Unless an output is M_RESTRICT it may be one of the inputs, e.g.
+// add_mod_p(a, a, b, p, t) computes a = a + b mod p in place.
 
 /**
  * One word addition with a carry bit
@@ -62,27 +65,30 @@ void multiply_words(uint16_t a_i, uint16_t b_i, uint16_t * uv);
  * Input: a, b \in [0,p-1]
  * Output: c = a*b
  */
-void multiply_mp_elements(uint16_t * c, uint16_t * a, uint16_t * b, uint8_t wordlength);
+void multiply_mp_elements(uint16_t * M_RESTRICT c, uint16_t * a, uint16_t * b, uint8_t wordlength);
 /**
  * Multiprecision Multiplication c.f. Alg. 2.9
  * Input: a, b \in [0,p-1]
- * Output: c = a*b
+ * Output: c = a*b of wordlength_a + wordlength_b words
  */
-void multiply_mp_elements2(uint16_t * c, uint16_t * a, uint8_t wordlength_a, uint16_t * b, uint8_t wordlength_b) ;
+void multiply_mp_elements2(uint16_t * M_RESTRICT c, uint16_t * a, uint8_t wordlength_a, uint16_t * b, uint8_t wordlength_b) ;
 /**
  * Sets a bn to zero
  */
-void set_to_zero(uint16_t * c, uint8_t wordlength);
+void set_to_zero(uint16_t * c, uint16_t wordlength);
 
 
 /**
  * Compares two big nums
  * Returns 1 if a >= b 0 otherwise
  */
-uint8_t compare_mp_elements(uint16_t * a, uint16_t * b, uint8_t wordlength);
+uint8_t compare_mp_elements(uint16_t * a, uint16_t * b, uint16_t wordlength);
 
-int are_mp_equal(uint16_t * a, uint16_t * b, uint8_t wordlength);
+int are_mp_equal(uint16_t * a, uint16_t * b, uint16_t wordlength);
 
+/**
+ * out = a*b^k mod b^{wordlength_out}
+ */
 void mult_by_power_of_b(uint16_t * out, uint16_t wordlength_out, uint16_t * a, uint16_t wordlength_a, uint16_t k);
 
 /*
@@ -101,20 +107,55 @@ void div_by_power_of_b(uint16_t * out, uint16_t * a, uint16_t k, uint16_t wordle
 
 void multiply_sp_by_mp_element(uint16_t * c, uint16_t a, uint16_t * b, uint16_t wordlength_b);
 
+/**
+ * Remainder of a BigNum by a single word, returns a mod d for d != 0
+ */
+uint16_t mp_mod_sp(uint16_t * a, uint16_t wordlength, uint16_t d);
+
 void copy_mp(uint16_t * out, uint16_t * in, int wordlength);
 
 int ith_bit(uint16_t e, int i);
 
+/**
+ * out = a mod b^k
+ */
 void mod_pow_of_b(uint16_t * out, uint16_t wordlength_out, uint16_t * a, uint16_t wordlength_a, uint16_t k);
 
 int bit_length(uint16_t e);
 
 int mp_bit_length(uint16_t * e, uint16_t wordlength);
 
-void multiply_mod_p(uint16_t * c, uint16_t * a, uint16_t * b, uint16_t * p, uint8_t wordlength);
+/**
+ * Multiprecision division c.f. Knuth TAOCP Vol. 2 Alg. 4.3.1 D
+ * Input: a of wordlength_a <= 2*MAX_WORDLENGTH words, b != 0 of
+ * wordlength_b <= MAX_WORDLENGTH words
+ * Output: q = a div b (wordlength_a words, may be NULL) and r = a mod b
+ * (wordlength_b words, may be NULL). r may be a or b
+ * Returns 1 on success 0 if b = 0 or the lengths are out of range
+ */
+int divide_mp_elements(uint16_t * M_RESTRICT q, uint16_t * r, uint16_t * a, uint16_t wordlength_a,
+        uint16_t * b, uint16_t wordlength_b);
+
+/**
+ * Multiplication in F_p
+ * Input: a, b \in [0,p-1), wordlength <= MAX_WORDLENGTH
+ * Output: c = a * b mod p
+ */
+void multiply_mod_p(uint16_t * c, uint16_t * a, uint16_t * b, uint16_t * p, uint16_t wordlength);
 
 int mp_ith_bit(uint16_t * e, int i);
 
+/**
+ * Returns the index of the most significant non-zero word of e, -1 if e = 0
+ */
+int mp_non_zero_words(uint16_t * e, uint16_t wordlength);
+
+/**
+ * Returns the k-bit window of e starting at bit i, i.e. (e >> i) mod 2^k.
+ * Bits beyond the wordlength of e read as zero. k must be at most 16.
+ */
+uint16_t mp_bits(uint16_t * e, uint16_t wordlength, int i, int k);
+
 #ifdef	__cplusplus
 }
 #endif
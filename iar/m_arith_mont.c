@@ -0,0 +1,329 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_mont.h"
+#include "m_gcd.h"
+
+/**
+ * Fills ctx for the modulus p
+ * Input: p odd, p > 1, wordlength <= MAX_WORDLENGTH
+ * Returns 1 on success 0 if p is not a valid modulus
+ */
+int mont_setup(mont_ctx_t * ctx, uint16_t * p, uint8_t wordlength) {
+    uint16_t inv;
+    int i;
+
+    if ((0 == wordlength) || (wordlength > MAX_WORDLENGTH) || (0 == (p[0] & 1))
+            || (0 == p[wordlength - 1])
+            || ((1 == wordlength) && (1 == p[0]))) {
+        return 0;
+    }
+    ctx->wordlength = wordlength;
+    copy_mp(ctx->p, p, wordlength);
+
+    //1. p^{-1} mod 2^W by Newton iteration, p*p = 1 mod 8 so 3 bits are correct to start
+    inv = p[0];
+    for (i = 0; i < 3; i++) {
+        inv = (uint16_t) (((uint32_t) inv) * ((uint32_t) (2 - (uint16_t) (((uint32_t) p[0]) * ((uint32_t) inv)))));
+    }
+    ctx->p_prime = (uint16_t) (0 - inv);
+
+    //2. R mod p and R^2 mod p by doubling 1, there is no division to lean on
+    set_to_zero(ctx->one, wordlength);
+    ctx->one[0] = 1;
+    for (i = 0; i < WORDSIZE * wordlength; i++) {
+        add_mod_p(ctx->one, ctx->one, ctx->one, ctx->p, wordlength);
+    }
+    copy_mp(ctx->r2, ctx->one, wordlength);
+    for (i = 0; i < WORDSIZE * wordlength; i++) {
+        add_mod_p(ctx->r2, ctx->r2, ctx->r2, ctx->p, wordlength);
+    }
+    return 1;
+}
+
+/**
+ * Montgomery multiplication c.f. HAC Alg. 14.36, interleaved as in CIOS
+ * Input: a, b \in [0,p-1]
+ * Output: c = a*b*R^{-1} mod p, c may be a or b
+ */
+void mont_multiply(mont_ctx_t * ctx, uint16_t * c, uint16_t * a, uint16_t * b) {
+    uint16_t T[MAX_WORDLENGTH + 2];
+    uint16_t * p = ctx->p;
+    int t = ctx->wordlength;
+    uint32_t uv;
+    uint16_t m;
+    int i, j;
+
+    set_to_zero(T, t + 2);
+    for (i = 0; i < t; i++) {
+        //1. T = T + a*b_i
+        uv = 0;
+        for (j = 0; j < t; j++) {
+            uv = ((uint32_t) T[j]) + ((uint32_t) a[j]) * ((uint32_t) b[i]) + (uv >> 16);
+            T[j] = (uint16_t) uv;
+        }
+        uv = ((uint32_t) T[t]) + (uv >> 16);
+        T[t] = (uint16_t) uv;
+        T[t + 1] = (uint16_t) (uv >> 16);
+
+        //2. T = (T + m*p)/W with m chosen so the division is exact
+        m = (uint16_t) (((uint32_t) T[0]) * ((uint32_t) ctx->p_prime));
+        uv = ((uint32_t) T[0]) + ((uint32_t) m) * ((uint32_t) p[0]);
+        for (j = 1; j < t; j++) {
+            uv = ((uint32_t) T[j]) + ((uint32_t) m) * ((uint32_t) p[j]) + (uv >> 16);
+            T[j - 1] = (uint16_t) uv;
+        }
+        uv = ((uint32_t) T[t]) + (uv >> 16);
+        T[t - 1] = (uint16_t) uv;
+        T[t] = T[t + 1] + (uint16_t) (uv >> 16);
+    }
+
+    //3. T < 2p
+    if ((0 != T[t]) || (1 == compare_mp_elements(T, p, t))) {
+        subtract_mp_elements(T, T, p, t);
+    }
+    copy_mp(c, T, t);
+}
+
+/**
+ * Montgomery reduction c.f. HAC Alg. 14.32
+ * Input: x \in [0, p*R) of x_wordlength <= 2*wordlength words
+ * Output: c = x*R^{-1} mod p
+ */
+void mont_reduce(mont_ctx_t * ctx, uint16_t * c, uint16_t * x, uint16_t x_wordlength) {
+    uint16_t T[2 * MAX_WORDLENGTH + 1];
+    uint16_t * p = ctx->p;
+    int t = ctx->wordlength;
+    uint32_t uv;
+    uint16_t m;
+    int i, j;
+
+    set_to_zero(T, 2 * t + 1);
+    copy_mp(T, x, x_wordlength);
+    for (i = 0; i < t; i++) {
+        //T = T + m*p*W^i, clearing word i
+        m = (uint16_t) (((uint32_t) T[i]) * ((uint32_t) ctx->p_prime));
+        uv = 0;
+        for (j = 0; j < t; j++) {
+            uv = ((uint32_t) T[i + j]) + ((uint32_t) m) * ((uint32_t) p[j]) + (uv >> 16);
+            T[i + j] = (uint16_t) uv;
+        }
+        for (j = i + t; (j < 2 * t + 1) && (0 != (uv >> 16)); j++) {
+            uv = ((uint32_t) T[j]) + (uv >> 16);
+            T[j] = (uint16_t) uv;
+        }
+    }
+    //T/R < 2p
+    if ((0 != T[2 * t]) || (1 == compare_mp_elements(&T[t], p, t))) {
+        subtract_mp_elements(&T[t], &T[t], p, t);
+    }
+    copy_mp(c, &T[t], t);
+}
+
+/**
+ * Reduction modulo p
+ * Input: x \in [0, p*R) of x_wordlength <= 2*wordlength words
+ * Output: c = x mod p
+ */
+void mont_mod(mont_ctx_t * ctx, uint16_t * c, uint16_t * x, uint16_t x_wordlength) {
+    //(x*R^{-1})*R^2*R^{-1} = x
+    mont_reduce(ctx, c, x, x_wordlength);
+    mont_multiply(ctx, c, c, ctx->r2);
+}
+
+/**
+ * Conversion into Montgomery form, c = a*R mod p
+ */
+void mont_to(mont_ctx_t * ctx, uint16_t * c, uint16_t * a) {
+    mont_multiply(ctx, c, a, ctx->r2);
+}
+
+/**
+ * Conversion out of Montgomery form, c = a*R^{-1} mod p
+ */
+void mont_from(mont_ctx_t * ctx, uint16_t * c, uint16_t * a) {
+    mont_reduce(ctx, c, a, ctx->wordlength);
+}
+
+/**
+ * Multiplication in F_p, c = a*b mod p for a, b \in [0,p-1] in normal form
+ */
+void multiply_mod_p_mont(mont_ctx_t * ctx, uint16_t * c, uint16_t * a, uint16_t * b) {
+    uint16_t temp[MAX_WORDLENGTH];
+
+    mont_multiply(ctx, temp, a, b);
+    mont_multiply(ctx, c, temp, ctx->r2);
+}
+
+/**
+ * Sliding window exponentiation c.f. HAC Alg. 14.85 with g and A in
+ * Montgomery form and windows of up to MONT_EXP_WINDOW bits
+ */
+void mont_exp_mont_form(mont_ctx_t * ctx, uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length) {
+    //g^1, g^3, ..., g^{2^k - 1}
+    uint16_t odd_powers[1 << (MONT_EXP_WINDOW - 1)][MAX_WORDLENGTH];
+    uint16_t g2[MAX_WORDLENGTH];
+    uint16_t X[MAX_WORDLENGTH]; // A, which may be g or e
+    int t = ctx->wordlength;
+    int first = 1;
+    int i, l, j;
+    uint16_t window;
+
+    //1. Precomputation
+    copy_mp(odd_powers[0], g, t);
+    mont_multiply(ctx, g2, g, g);
+    for (j = 1; j < (1 << (MONT_EXP_WINDOW - 1)); j++) {
+        mont_multiply(ctx, odd_powers[j], odd_powers[j - 1], g2);
+    }
+
+    if (mp_non_zero_words(e, e_length) < 0) {
+        copy_mp(A, ctx->one, t);
+        return;
+    }
+    //2. Scan e from its most significant bit
+    i = mp_bit_length(e, e_length);
+    while (i >= 0) {
+        if (0 == mp_ith_bit(e, i)) {
+            if (0 == first) {
+                mont_multiply(ctx, X, X, X);
+            }
+            i--;
+        } else {
+            //2.1 Longest window e_i..e_l of at most k bits ending in a one
+            l = (i - MONT_EXP_WINDOW + 1 > 0) ? (i - MONT_EXP_WINDOW + 1) : 0;
+            while (0 == mp_ith_bit(e, l)) {
+                l++;
+            }
+            window = mp_bits(e, e_length, l, i - l + 1);
+            //2.2 X = X^{2^{i-l+1}} * g^window
+            if (0 == first) {
+                for (j = l; j <= i; j++) {
+                    mont_multiply(ctx, X, X, X);
+                }
+                mont_multiply(ctx, X, X, odd_powers[window >> 1]);
+            } else {
+                copy_mp(X, odd_powers[window >> 1], t);
+                first = 0;
+            }
+            i = l - 1;
+        }
+    }
+    copy_mp(A, X, t);
+}
+
+/**
+ * Left to right modular exponentiation with Montgomery multiplication
+ * and a sliding window of MONT_EXP_WINDOW bits
+ */
+void mont_exp(mont_ctx_t * ctx, uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length) {
+    uint16_t g_m[MAX_WORDLENGTH];
+
+    mont_to(ctx, g_m, g);
+    mont_exp_mont_form(ctx, A, g_m, e, e_length);
+    mont_from(ctx, A, A);
+}
+
+/**
+ * Square root modulo a prime p by the Tonelli-Shanks algorithm
+ * c.f. HAC Alg. 3.34
+ */
+int sqrt_mod_p_mont(mont_ctx_t * ctx, uint16_t * r, uint16_t * a) {
+    uint16_t q[MAX_WORDLENGTH];
+    uint16_t x[MAX_WORDLENGTH];
+    uint16_t b[MAX_WORDLENGTH];
+    uint16_t g[MAX_WORDLENGTH];
+    uint16_t w[MAX_WORDLENGTH];
+    uint16_t z;
+    int t = ctx->wordlength;
+    int s, m, k, i;
+
+    if (mp_non_zero_words(a, t) < 0) {
+        set_to_zero(r, t);
+        return 1;
+    }
+    if (-1 == jacobi(a, ctx->p, t)) {
+        return 0;
+    }
+
+    //1. p - 1 = q*2^s with q odd
+    copy_mp(q, ctx->p, t);
+    q[0] &= 0xFFFE;
+    s = 0;
+    while (0 == mp_ith_bit(q, s)) {
+        s++;
+    }
+    for (i = 0; i < t; i++) {
+        q[i] = mp_bits(q, t, 16 * i + s, 16);
+    }
+
+    //2. Find a non residue z by its Jacobi symbol, g = z^q
+    set_to_zero(w, t);
+    z = 1;
+    do {
+        z++;
+        w[0] = z;
+    } while (-1 != jacobi(w, ctx->p, t));
+    mont_to(ctx, g, w);
+    mont_exp_mont_form(ctx, g, g, q, t);
+    //g = z^q generates the 2-Sylow subgroup
+
+    //3. w = a^{(q-1)/2}, x = a^{(q+1)/2}, b = a^q
+    mont_to(ctx, x, a);
+    q[0] &= 0xFFFE;
+    for (i = 0; i < t; i++) {
+        q[i] = mp_bits(q, t, 16 * i + 1, 16);
+    }
+    mont_exp_mont_form(ctx, w, x, q, t);
+    mont_multiply(ctx, x, x, w);
+    mont_multiply(ctx, b, x, w);
+
+    //4. Shrink the order of b until it is 1
+    while (0 == are_mp_equal(b, ctx->one, t)) {
+        //4.1 least m with b^{2^m} = 1
+        copy_mp(w, b, t);
+        m = 0;
+        while ((m < s) && (0 == are_mp_equal(w, ctx->one, t))) {
+            mont_multiply(ctx, w, w, w);
+            m++;
+        }
+        if (m == s) {
+            //a is not a square
+            return 0;
+        }
+        //4.2 w = g^{2^{s-m-1}}, g = w^2, x = x*w, b = b*g
+        copy_mp(w, g, t);
+        for (k = 0; k < s - m - 1; k++) {
+            mont_multiply(ctx, w, w, w);
+        }
+        mont_multiply(ctx, g, w, w);
+        mont_multiply(ctx, x, x, w);
+        mont_multiply(ctx, b, b, g);
+        s = m;
+    }
+    mont_from(ctx, r, x);
+    return 1;
+}
@@ -0,0 +1,108 @@
+/*
+ * File:   m_arith_mont.h
+ *
+ * Montgomery arithmetic modulo a general odd p of up to MAX_WORDLENGTH words.
+ */
+
+#ifndef M_ARITH_MONT_H
+#define	M_ARITH_MONT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+#include "m_defs.h"
+
+/**
+ * Precomputed values for a modulus p with R = 2^{W*wordlength}
+ */
+typedef struct {
+    uint16_t p[MAX_WORDLENGTH];
+    uint16_t r2[MAX_WORDLENGTH];  // R^2 mod p
+    uint16_t one[MAX_WORDLENGTH]; // R mod p, i.e. 1 in Montgomery form
+    uint16_t p_prime;             // -p^{-1} mod 2^W
+    uint8_t wordlength;
+} mont_ctx_t;
+
+/**
+ * Fills ctx for the modulus p
+ * Input: p odd, p > 1, wordlength <= MAX_WORDLENGTH
+ * Returns 1 on success 0 if p is not a valid modulus
+ */
+int mont_setup(mont_ctx_t * ctx, uint16_t * p, uint8_t wordlength);
+
+/**
+ * Montgomery multiplication c.f. Alg. 2.36 (CIOS)
+ * Input: a, b \in [0,p-1]
+ * Output: c = a*b*R^{-1} mod p, c may be a or b
+ */
+void mont_multiply(mont_ctx_t * ctx, uint16_t * c, uint16_t * a, uint16_t * b);
+
+/**
+ * Montgomery reduction
+ * Input: x \in [0, p*R) of x_wordlength <= 2*wordlength words
+ * Output: c = x*R^{-1} mod p
+ */
+void mont_reduce(mont_ctx_t * ctx, uint16_t * c, uint16_t * x, uint16_t x_wordlength);
+
+/**
+ * Reduction modulo p
+ * Input: x \in [0, p*R) of x_wordlength <= 2*wordlength words
+ * Output: c = x mod p
+ */
+void mont_mod(mont_ctx_t * ctx, uint16_t * c, uint16_t * x, uint16_t x_wordlength);
+
+/**
+ * Conversion into Montgomery form, c = a*R mod p
+ */
+void mont_to(mont_ctx_t * ctx, uint16_t * c, uint16_t * a);
+
+/**
+ * Conversion out of Montgomery form, c = a*R^{-1} mod p
+ */
+void mont_from(mont_ctx_t * ctx, uint16_t * c, uint16_t * a);
+
+/**
+ * Multiplication in F_p, c = a*b mod p for a, b \in [0,p-1] in normal form
+ */
+void multiply_mod_p_mont(mont_ctx_t * ctx, uint16_t * c, uint16_t * a, uint16_t * b);
+
+/**
+ * Left to right modular exponentiation with Montgomery multiplication
+ * and a sliding window of MONT_EXP_WINDOW bits
+ *
+ * @param A The result of raising g to the power of e modulo p, A may be g or e
+ * @param g an element of [0,p-1]
+ * @param e a multi-precission exponent
+ * @param e_length the wordlength of the multi-precission exponent
+ */
+void mont_exp(mont_ctx_t * ctx, uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length);
+
+/**
+ * mont_exp with g and A in Montgomery form, for callers that keep working
+ * on A in Montgomery form. A zero e gives ctx->one.
+ *
+ * @param A g^e*R^{1-e} mod p, i.e. g^e in Montgomery form, A may be g or e
+ * @param g an element of [0,p-1] in Montgomery form
+ * @param e a multi-precission exponent
+ * @param e_length the wordlength of the multi-precission exponent
+ */
+void mont_exp_mont_form(mont_ctx_t * ctx, uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length);
+
+/**
+ * Square root modulo a prime p by the Tonelli-Shanks algorithm
+ * c.f. HAC Alg. 3.34
+ *
+ * @param r a square root of a, if one exists
+ * @param a an element of [0,p-1]
+ * @return 1 if a is a square modulo p, 0 otherwise
+ */
+int sqrt_mod_p_mont(mont_ctx_t * ctx, uint16_t * r, uint16_t * a);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_ARITH_MONT_H */
+
@@ -37,72 +37,62 @@
 #endif
 /**
  * Fast reduction modulo p = p_192 = 2^{192} - 2^{64} -1 c.f Alg. 2.27
- * Input: c, s.t 0<= c <= p^2
- * Output: c mod p
+ * Input: c, s.t 0<= c < 2^{384}
+ * Output: c mod p, c_out may be c. The running time does not depend on c
  */
 void reduce_mod_p(uint16_t * c, uint16_t * p, uint16_t * c_out) {
-    uint16_t s1[12];
-    uint16_t s2[12];
-    uint16_t s3[12];
-    uint16_t s4[12];
+    uint16_t d[12];
+    uint32_t acc;
+    uint32_t borrow;
+    uint16_t top;
+    uint16_t mask;
+    int i, k;
 
-    s1[0] = c[0 + 0];
-    s1[1] = c[1 + 0];
-    s1[2] = c[2 + 0];
-    s1[3] = c[3 + 0];
-    s1[4] = c[0 + 4];
-    s1[5] = c[1 + 4];
-    s1[6] = c[2 + 4];
-    s1[7] = c[3 + 4];
-    s1[8] = c[0 + 8];
-    s1[9] = c[1 + 8];
-    s1[10] = c[2 + 8];
-    s1[11] = c[3 + 8];
-
-    s2[0] = c[0 + 12];
-    s2[1] = c[1 + 12];
-    s2[2] = c[2 + 12];
-    s2[3] = c[3 + 12];
-    s2[4] = c[0 + 12];
-    s2[5] = c[1 + 12];
-    s2[6] = c[2 + 12];
-    s2[7] = c[3 + 12];
-    s2[8] = 0;
-    s2[9] = 0;
-    s2[10] = 0;
-    s2[11] = 0;
-
-    s3[0] = 0;
-    s3[1] = 0;
-    s3[2] = 0;
-    s3[3] = 0;
-    s3[4] = c[0 + 16];
-    s3[5] = c[1 + 16];
-    s3[6] = c[2 + 16];
-    s3[7] = c[3 + 16];
-    s3[8] = c[0 + 16];
-    s3[9] = c[1 + 16];
-    s3[10] = c[2 + 16];
-    s3[11] = c[3 + 16];
-
-    s4[0] = c[0 + 20];
-    s4[1] = c[1 + 20];
-    s4[2] = c[2 + 20];
-    s4[3] = c[3 + 20];
-    s4[4] = c[0 + 20];
-    s4[5] = c[1 + 20];
-    s4[6] = c[2 + 20];
-    s4[7] = c[3 + 20];
-    s4[8] = c[0 + 20];
-    s4[9] = c[1 + 20];
-    s4[10] = c[2 + 20];
-    s4[11] = c[3 + 20];
+    //1. With 64-bit words c = (c5,...,c0) sum T + S1 + S2 + S3 column-wise,
+    //   T = (c2,c1,c0), S1 = (0,c3,c3), S2 = (c4,c4,0), S3 = (c5,c5,c5).
+    //   Word i of c_out only overwrites word i of c, which is not read again.
+    acc = 0;
+    for (i = 0; i < 12; i++) {
+        acc += (uint32_t) c[i];
+        acc += (uint32_t) c[20 + (i & 3)];
+        if (i < 8) {
+            acc += (uint32_t) c[12 + (i & 3)];
+        }
+        if (i >= 4) {
+            acc += (uint32_t) c[16 + (i & 3)];
+        }
+        c_out[i] = (uint16_t) acc;
+        acc >>= 16;
+    }
+    top = (uint16_t) acc;
 
-    //return s1 + s2 + s3 +s4
+    //2. Fold the carries back in with 2^{192} = 2^{64} + 1 mod p. Two
+    //   passes always suffice (top <= 3, then <= 1, then 0) and always
+    //   running both keeps the time independent of c
+    for (k = 0; k < 2; k++) {
+        acc = top;
+        for (i = 0; i < 12; i++) {
+            acc += (uint32_t) c_out[i];
+            if (4 == i) {
+                acc += top;
+            }
+            c_out[i] = (uint16_t) acc;
+            acc >>= 16;
+        }
+        top = (uint16_t) acc;
+    }
 
-    add_mod_p(c_out, s3, s4, p, 12);
-    add_mod_p(c_out, c_out, s2, p, 12);
-    add_mod_p(c_out, c_out, s1, p, 12);
+    //3. c_out < 2^{192} < 2p, subtract p unless it borrows, without branching
+    borrow = 0;
+    for (i = 0; i < 12; i++) {
+        acc = (uint32_t) c_out[i] - (uint32_t) p[i] - borrow;
+        d[i] = (uint16_t) acc;
+        borrow = (acc >> 16) & 1;
+    }
+    mask = (uint16_t) (borrow - 1);
+    for (i = 0; i < 12; i++) {
+        c_out[i] = (uint16_t) ((d[i] & mask) | (c_out[i] & ~mask));
+    }
 }
 
 void multiply_mod_p_192(uint16_t * c, uint16_t * a, uint16_t * b) {
@@ -128,18 +118,19 @@ void multiply_mod_p_192(uint16_t * c, uint16_t * a, uint16_t * b) {
  * @param e a single precission exponent
  */
 void mod_exp_p_192_lr(uint16_t * A, uint16_t * g, uint16_t e) {
-    uint16_t temp[12];
+    uint16_t X[12];
     int i;
     int t = bit_length(e);
 
-    //1.
+    //1. Work in place on X, multiply_mod_p_192 is alias-safe. A is only
+    //written at the end so that it may be g
 #ifdef DEBUG_PRINTF
     printf("1.\n");
 #endif
-    set_to_zero(A, 12);
-    A[0] = 1;
+    set_to_zero(X, 12);
+    X[0] = 1;
 #ifdef DEBUG_PRINTF
-    print_bn((uint8_t *) "A", A, 12);
+    print_bn((uint8_t *) "A", X, 12);
     print_bn((uint8_t *) "g", g, 12);
 #endif
     //2.
@@ -149,44 +140,21 @@ void mod_exp_p_192_lr(uint16_t * A, uint16_t * g, uint16_t e) {
         printf("exp i: %d\n", i);
 #endif
         //2.1 A = A*A mod p
-        multiply_mod_p_192(temp, A, A);
+        multiply_mod_p_192(X, X, X);
 #ifdef DEBUG_PRINTF
-        print_bn((uint8_t *) "A*A mod p", temp, 12);
+        print_bn((uint8_t *) "A*A mod p", X, 12);
 #endif
-        copy_mp(A, temp, 12);
-        //2.2 If e_i = 1 then A = Mont(A,x_hat)
+        //2.2 If e_i = 1 then A = A*g mod p
         if (1 == ith_bit(e, i)) {
+            multiply_mod_p_192(X, X, g);
 #ifdef DEBUG_PRINTF
-            printf("%d-bit = 1\n", i);
-#endif
-            multiply_mod_p_192(temp, A, g);
-#ifdef DEBUG_PRINTF
-            print_bn((uint8_t *) "A*g", temp, 12);
-#endif
-            copy_mp(A, temp, 12);
-#ifdef DEBUG_PRINTF
-            printf("exting here?\n");
+            print_bn((uint8_t *) "A*g", X, 12);
 #endif
         }
-#ifdef DEBUG_PRINTF
-        printf("or exting here?\n");
-#endif
     }
-    /*
-    for (i = t - 1; i >= 0; i = i-1){
-        printf("exp i: %d\n", i);
-        //2.1 A = A*A mod p
-        multiply_mod_p_192(temp, A, A);
-        print_bn((uint8_t *) "A*A mod p", temp, 12);
-        copy_mp(A, temp, 12);
-    }*/
 
     //3.
-#ifdef DEBUG_PRINTF
-    printf("result:\n");
-#endif
-    //copy_mp(out,A,12);
-
+    copy_mp(A, X, 12);
 }
 
 /**
@@ -200,18 +168,19 @@ void mod_exp_p_192_lr(uint16_t * A, uint16_t * g, uint16_t e) {
  */
 
 void mod_exp_p_192(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length) {
-    uint16_t temp[12];
+    uint16_t X[12];
     int i;
     int t = mp_bit_length(e,e_length);
 
-    //1.
+    //1. Work in place on X, multiply_mod_p_192 is alias-safe. A is only
+    //written at the end so that it may be g
 #ifdef DEBUG_PRINTF
     printf("1.\n");
 #endif
-    set_to_zero(A, 12);
-    A[0] = 1;
+    set_to_zero(X, 12);
+    X[0] = 1;
 #ifdef DEBUG_PRINTF
-    print_bn((uint8_t *) "A", A, 12);
+    print_bn((uint8_t *) "A", X, 12);
     print_bn((uint8_t *) "g", g, 12);
 #endif
     //2.
@@ -221,43 +190,151 @@ void mod_exp_p_192(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length)
         printf("exp i: %d\n", i);
 #endif
         //2.1 A = A*A mod p
-        multiply_mod_p_192(temp, A, A);
+        multiply_mod_p_192(X, X, X);
 #ifdef DEBUG_PRINTF
-        print_bn((uint8_t *) "A*A mod p", temp, 12);
+        print_bn((uint8_t *) "A*A mod p", X, 12);
 #endif
-        copy_mp(A, temp, 12);
-        //2.2 If e_i = 1 then A = Mont(A,x_hat)
+        //2.2 If e_i = 1 then A = A*g mod p
         if (1 == mp_ith_bit(e, i)) {
+            multiply_mod_p_192(X, X, g);
 #ifdef DEBUG_PRINTF
-            printf("%d-bit = 1\n", i);
-#endif
-            multiply_mod_p_192(temp, A, g);
-#ifdef DEBUG_PRINTF
-            print_bn((uint8_t *) "A*g", temp, 12);
-#endif
-            copy_mp(A, temp, 12);
-#ifdef DEBUG_PRINTF
-            printf("exting here?\n");
+            print_bn((uint8_t *) "A*g", X, 12);
 #endif
         }
-#ifdef DEBUG_PRINTF
-        printf("or exting here?\n");
-#endif
     }
-    /*
-    for (i = t - 1; i >= 0; i = i-1){
-        printf("exp i: %d\n", i);
-        //2.1 A = A*A mod p
-        multiply_mod_p_192(temp, A, A);
-        print_bn((uint8_t *) "A*A mod p", temp, 12);
-        copy_mp(A, temp, 12);
-    }*/
 
     //3.
-#ifdef DEBUG_PRINTF
-    printf("result:\n");
-#endif
-    //copy_mp(out,A,12);
+    copy_mp(A, X, 12);
+}
 
+/**
+ * Square root modulo p_192. Since p = 3 mod 4 a root is a^{(p+1)/4} and
+ * (p+1)/4 = (2^{128} - 1)*2^{62}, so instead of a generic exponentiation
+ * the run of ones is built with the addition chain 1, 2, 4, ..., 128
+ * (x_{2k} = x_k^{2^k} * x_k with x_k = a^{2^k - 1}) followed by 62 squarings:
+ * 189 squarings and 7 multiplications in total.
+ *
+ * @param r a square root of a, if one exists
+ * @param a an element of [0,p-1]
+ * @return 1 if a is a square modulo p, 0 otherwise
+ */
+int sqrt_mod_p_192(uint16_t * r, uint16_t * a) {
+    uint16_t x[12];
+    uint16_t y[12];
+    int is_square;
+    int i, k;
+
+    //1. x = a^{2^{128} - 1}
+    copy_mp(x, a, 12);
+    for (k = 1; k < 128; k = 2 * k) {
+        copy_mp(y, x, 12);
+        for (i = 0; i < k; i++) {
+            multiply_mod_p_192(y, y, y);
+        }
+        multiply_mod_p_192(x, y, x);
+    }
+    //2. x = x^{2^{62}}
+    for (i = 0; i < 62; i++) {
+        multiply_mod_p_192(x, x, x);
+    }
+    //3. Only squares come back to a, r may be a
+    multiply_mod_p_192(y, x, x);
+    is_square = are_mp_equal(y, a, 12);
+    copy_mp(r, x, 12);
+    return is_square;
+}
+
+/**
+ * Constant-time selection of entry idx of a table of n 12-word entries.
+ * Every entry is read and masked, so the memory access pattern does not
+ * depend on idx
+ */
+static void table_select_ct(uint16_t * out, uint16_t table[][12], int n, uint16_t idx) {
+    uint16_t mask;
+    int i, j;
+
+    set_to_zero(out, 12);
+    for (j = 0; j < n; j++) {
+        //0xFFFF if j = idx, 0 otherwise
+        mask = (uint16_t) ((((uint32_t) (j ^ idx)) - 1) >> 16);
+        for (i = 0; i < 12; i++) {
+            out[i] |= table[j][i] & mask;
+        }
+    }
 }
 
+/**
+ * Fixed window exponentiation c.f. HAC Alg. 14.82 with windows of
+ * CT_EXP_WINDOW bits over all 16*e_length bits of e. Every window costs
+ * the same squarings and one multiplication, by g^0 = 1 for a zero digit,
+ * and the table lookup is constant-time.
+ */
+void mod_exp_p_192_ct(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length) {
+    uint16_t table[1 << CT_EXP_WINDOW][12];
+    uint16_t X[12];
+    uint16_t Y[12];
+    int i, j;
+
+    //1. table[j] = g^j
+    set_to_zero(table[0], 12);
+    table[0][0] = 1;
+    copy_mp(table[1], g, 12);
+    for (j = 2; j < (1 << CT_EXP_WINDOW); j++) {
+        multiply_mod_p_192(table[j], table[j - 1], g);
+    }
+
+    //2. Windows from the most significant one, the first may be short
+    i = 16 * e_length - ((16 * e_length) % CT_EXP_WINDOW);
+    if (i == 16 * e_length) {
+        i -= CT_EXP_WINDOW;
+    }
+    table_select_ct(X, table, 1 << CT_EXP_WINDOW, mp_bits(e, e_length, i, CT_EXP_WINDOW));
+    for (i -= CT_EXP_WINDOW; i >= 0; i -= CT_EXP_WINDOW) {
+        for (j = 0; j < CT_EXP_WINDOW; j++) {
+            multiply_mod_p_192(X, X, X);
+        }
+        table_select_ct(Y, table, 1 << CT_EXP_WINDOW, mp_bits(e, e_length, i, CT_EXP_WINDOW));
+        multiply_mod_p_192(X, X, Y);
+    }
+    copy_mp(A, X, 12);
+}
+
+/**
+ * Swaps a and b if bit = 1, without branching on bit
+ */
+static void cswap_ct(uint16_t * a, uint16_t * b, uint16_t bit) {
+    uint16_t mask = (uint16_t) (0 - bit);
+    uint16_t t;
+    int i;
+
+    for (i = 0; i < 12; i++) {
+        t = (a[i] ^ b[i]) & mask;
+        a[i] ^= t;
+        b[i] ^= t;
+    }
+}
+
+/**
+ * Montgomery ladder c.f. Joye and Yen, "The Montgomery Powering Ladder",
+ * over all 16*e_length bits of e. Every bit costs one multiplication and
+ * one squaring, R1/R0 = g is kept invariant.
+ */
+void mod_exp_p_192_ladder(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length) {
+    uint16_t R0[12];
+    uint16_t R1[12];
+    uint16_t bit;
+    int i;
+
+    set_to_zero(R0, 12);
+    R0[0] = 1;
+    copy_mp(R1, g, 12);
+    for (i = 16 * e_length - 1; i >= 0; i--) {
+        bit = (uint16_t) ((e[i >> 4] >> (i & 15)) & 1);
+        //(R0, R1) = (R0^2, R0*R1) if bit = 0, (R0*R1, R1^2) otherwise
+        cswap_ct(R0, R1, bit);
+        multiply_mod_p_192(R1, R0, R1);
+        multiply_mod_p_192(R0, R0, R0);
+        cswap_ct(R0, R1, bit);
+    }
+    copy_mp(A, R0, 12);
+}
@@ -15,18 +15,21 @@ extern "C" {
 
 /**
  * Fast reduction modulo p = p_192 = 2^{192} - 2^{64} -1 c.f Alg. 2.27
- * Input: c, s.t 0<= c <= p^2
- * Output: c mod p
+ * Input: c, s.t 0<= c < 2^{384}
+ * Output: c mod p, c_out may be c
  */
 void reduce_mod_p(uint16_t * c, uint16_t * p, uint16_t * c_out);
 
+/**
+ * Multiplication in F_p, c = a*b mod p_192, c may be a or b
+ */
 void multiply_mod_p_192(uint16_t * c, uint16_t * a, uint16_t * b);
 
 /**
  * Implementation of the left to right modular exponentiation algorithm
  * as described in the HAC book by Menezes et.al.
  *
- * @param A The result of raising g to the power of e
+ * @param A The result of raising g to the power of e, may be g
  * @param g an element of Z*_p
  * @param e a single precission exponent
  */
@@ -36,13 +39,46 @@ void mod_exp_p_192_lr(uint16_t * A, uint16_t * g, uint16_t e);
  * Implementation of the left to right modular exponentiation algorithm
  * as described in the HAC book by Menezes et.al.
  *
- * @param A The result of raising g to the power of e
+ * @param A The result of raising g to the power of e, may be g
  * @param g an element of Z*_p
  * @param e a multi-precission exponent
  * @param e_legth the wordlength of the multi-precission exponent
  */
 void mod_exp_p_192(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length);
 
+/**
+ * Exponentiation with a fixed schedule: fixed windows of CT_EXP_WINDOW bits
+ * over all 16*e_length bits of e and constant-time table lookups. The
+ * operations and memory accesses depend only on e_length, not on e.
+ *
+ * @param A The result of raising g to the power of e, may be g
+ * @param g an element of Z*_p
+ * @param e a multi-precission exponent
+ * @param e_length the wordlength of the multi-precission exponent
+ */
+void mod_exp_p_192_ct(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length);
+
+/**
+ * Exponentiation by the Montgomery ladder with branch-free conditional
+ * swaps, one multiplication and one squaring for each of the 16*e_length
+ * bits of e. Slower than mod_exp_p_192_ct but needs no table.
+ *
+ * @param A The result of raising g to the power of e, may be g
+ * @param g an element of Z*_p
+ * @param e a multi-precission exponent
+ * @param e_length the wordlength of the multi-precission exponent
+ */
+void mod_exp_p_192_ladder(uint16_t * A, uint16_t * g, uint16_t * e, uint16_t e_length);
+
+/**
+ * Square root modulo p_192 with a fixed addition chain for (p+1)/4
+ *
+ * @param r a square root of a, if one exists
+ * @param a an element of [0,p-1]
+ * @return 1 if a is a square modulo p, 0 otherwise
+ */
+int sqrt_mod_p_192(uint16_t * r, uint16_t * a);
+
 #ifdef	__cplusplus
 }
 #endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_arith_p192_split.h"
+
+/*
+ * One chunk, out = base^e
+ */
+typedef struct {
+    uint16_t out[WORDLENGTH];
+    uint16_t e[WORDLENGTH];
+    uint16_t * base;
+    uint16_t e_length;
+} split_chunk_t;
+
+static void * split_chunk_exp(void * arg) {
+    split_chunk_t * chunk = (split_chunk_t *) arg;
+
+    if (mp_non_zero_words(chunk->e, chunk->e_length) < 0) {
+        set_to_zero(chunk->out, WORDLENGTH);
+        chunk->out[0] = 1;
+    } else {
+        mod_exp_p_192(chunk->out, chunk->base, chunk->e, chunk->e_length);
+    }
+    return NULL;
+}
+
+#ifdef M_USE_PTHREADS
+/*
+ * Takes unclaimed chunks of the current call until none is left, with the
+ * pool lock held on entry and on return
+ */
+static void split_pool_drain(split_pool_t * pool) {
+    split_chunk_t * chunks = (split_chunk_t *) pool->chunks;
+    int i;
+
+    while (pool->next < pool->count) {
+        i = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        split_chunk_exp(&chunks[i]);
+        pthread_mutex_lock(&pool->lock);
+        if (0 == --pool->pending) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+}
+
+static void * split_worker(void * arg) {
+    split_pool_t * pool = (split_pool_t *) arg;
+    unsigned int seen;
+
+    pthread_mutex_lock(&pool->lock);
+    seen = pool->generation;
+    for (;;) {
+        while ((0 == pool->stop) && (seen == pool->generation)) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (0 != pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        split_pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+#endif
+
+/**
+ * Starts up to workers threads
+ */
+int split_pool_init(split_pool_t * pool, int workers) {
+    pool->workers = 0;
+#ifdef M_USE_PTHREADS
+    if (workers > M_SPLIT_MAX_CHUNKS - 1) {
+        workers = M_SPLIT_MAX_CHUNKS - 1;
+    }
+    pool->chunks = NULL;
+    pool->generation = 0;
+    pool->count = 0;
+    pool->next = 0;
+    pool->pending = 0;
+    pool->stop = 0;
+    pool->ready = 0;
+    if (0 != pthread_mutex_init(&pool->lock, NULL)) {
+        return 0;
+    }
+    if (0 != pthread_cond_init(&pool->start, NULL)) {
+        pthread_mutex_destroy(&pool->lock);
+        return 0;
+    }
+    if (0 != pthread_cond_init(&pool->done, NULL)) {
+        pthread_cond_destroy(&pool->start);
+        pthread_mutex_destroy(&pool->lock);
+        return 0;
+    }
+    pool->ready = 1;
+    while ((pool->workers < workers)
+            && (0 == pthread_create(&pool->threads[pool->workers], NULL, split_worker, pool))) {
+        pool->workers++;
+    }
+#else
+    (void) workers;
+#endif
+    return pool->workers;
+}
+
+/**
+ * Stops and joins the threads of the pool
+ */
+void split_pool_destroy(split_pool_t * pool) {
+#ifdef M_USE_PTHREADS
+    int i;
+
+    if (0 == pool->ready) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->workers; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    pthread_mutex_destroy(&pool->lock);
+    pool->ready = 0;
+#endif
+    pool->workers = 0;
+}
+
+/**
+ * Precomputes the chunk bases g_i = g^{2^{i*m}} for 0 <= i < k
+ */
+void split_bases_p_192(uint16_t * bases, uint16_t * g, int k, int m) {
+    int i, j;
+
+    copy_mp(bases, g, WORDLENGTH);
+    for (i = 1; i < k; i++) {
+        copy_mp(&bases[WORDLENGTH * i], &bases[WORDLENGTH * (i - 1)], WORDLENGTH);
+        for (j = 0; j < m; j++) {
+            multiply_mod_p_192(&bases[WORDLENGTH * i], &bases[WORDLENGTH * i], &bases[WORDLENGTH * i]);
+        }
+    }
+}
+
+/**
+ * Computes A = g^e as prod_i g_i^{e_i} where e_i is the i-th m-bit chunk of e
+ */
+int mod_exp_p_192_split(uint16_t * A, split_pool_t * pool, uint16_t * bases, int k, int m, uint16_t * e, uint16_t e_length) {
+    split_chunk_t chunks[M_SPLIT_MAX_CHUNKS];
+    int serial = k; // chunks left to the calling thread
+    int i, w;
+
+    if ((k < 1) || (k > M_SPLIT_MAX_CHUNKS) || (m < 1) || (m > 16 * WORDLENGTH)) {
+        return 0;
+    }
+    if ((mp_non_zero_words(e, e_length) >= 0) && (mp_bit_length(e, e_length) >= k * m)) {
+        return 0;
+    }
+
+    //1. e_i = (e >> i*m) mod 2^m
+    for (i = 0; i < k; i++) {
+        chunks[i].base = &bases[WORDLENGTH * i];
+        chunks[i].e_length = (uint16_t) ((m + 15) / 16);
+        for (w = 0; w < chunks[i].e_length; w++) {
+            chunks[i].e[w] = mp_bits(e, e_length, i * m + 16 * w, (m - 16 * w < 16) ? (m - 16 * w) : 16);
+        }
+    }
+
+    //2. g_i^{e_i}, shared between the workers and the calling thread
+#ifdef M_USE_PTHREADS
+    if ((NULL != pool) && (pool->workers > 0) && (k > 1)) {
+        pthread_mutex_lock(&pool->lock);
+        pool->chunks = chunks;
+        pool->count = k;
+        pool->next = 0;
+        pool->pending = k;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->start);
+        split_pool_drain(pool);
+        while (pool->pending > 0) {
+            pthread_cond_wait(&pool->done, &pool->lock);
+        }
+        pool->chunks = NULL;
+        pthread_mutex_unlock(&pool->lock);
+        serial = 0;
+    }
+#else
+    (void) pool;
+#endif
+    for (i = 0; i < serial; i++) {
+        split_chunk_exp(&chunks[i]);
+    }
+
+    //3. A = prod_i g_i^{e_i}
+    copy_mp(A, chunks[0].out, WORDLENGTH);
+    for (i = 1; i < k; i++) {
+        multiply_mod_p_192(A, A, chunks[i].out);
+    }
+    return 1;
+}
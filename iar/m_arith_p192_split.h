@@ -0,0 +1,91 @@
+/*
+ * File:   m_arith_p192_split.h
+ *
+ * Exponentiation modulo p_192 with the exponent split in chunks that are
+ * worked on concurrently, for the latency of a single long exponentiation.
+ */
+
+#ifndef M_ARITH_P192_SPLIT_H
+#define	M_ARITH_P192_SPLIT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+#include "m_defs.h"
+
+#ifdef M_USE_PTHREADS
+#include <pthread.h>
+#endif
+
+#define M_SPLIT_MAX_CHUNKS 16
+
+/**
+ * Worker threads for mod_exp_p_192_split, started once by split_pool_init so
+ * that a call only wakes them. A pool serves one call at a time. Without
+ * M_USE_PTHREADS it has no workers and the chunks run on the calling thread.
+ */
+typedef struct {
+#ifdef M_USE_PTHREADS
+    pthread_t threads[M_SPLIT_MAX_CHUNKS - 1];
+    pthread_mutex_t lock;
+    pthread_cond_t start;    // a call has published its chunks
+    pthread_cond_t done;     // the last chunk of a call has finished
+    void * chunks;
+    unsigned int generation; // incremented by every call
+    int count;               // chunks of the current call
+    int next;                // next unclaimed chunk
+    int pending;             // chunks not finished yet
+    int stop;
+    int ready;               // the lock and the conditions exist
+#endif
+    int workers;
+} split_pool_t;
+
+/**
+ * Starts up to workers threads, at most M_SPLIT_MAX_CHUNKS - 1
+ * Returns the number of threads started, always 0 without M_USE_PTHREADS
+ */
+int split_pool_init(split_pool_t * pool, int workers);
+
+/**
+ * Stops and joins the threads of the pool, does nothing for a pool whose
+ * split_pool_init failed
+ */
+void split_pool_destroy(split_pool_t * pool);
+
+/**
+ * Precomputes the chunk bases g_i = g^{2^{i*m}} for 0 <= i < k
+ *
+ * @param bases output, k consecutive 12-word elements
+ * @param g an element of Z*_p
+ * @param k the number of chunks
+ * @param m the chunk length in bits
+ */
+void split_bases_p_192(uint16_t * bases, uint16_t * g, int k, int m);
+
+/**
+ * Computes A = g^e as prod_i g_i^{e_i} where e_i is the i-th m-bit chunk of
+ * e. The workers of the pool and the calling thread take chunks in turn, so
+ * with k - 1 workers the latency is about that of one m-bit exponentiation
+ * plus k - 1 multiplications.
+ *
+ * @param A The result of raising g to the power of e, A may be e
+ * @param pool a pool from split_pool_init, or NULL to run every chunk on the
+ *        calling thread
+ * @param bases the k chunk bases from split_bases_p_192 or table_split_bases_p_192
+ * @param k the number of chunks, at most M_SPLIT_MAX_CHUNKS
+ * @param m the chunk length in bits, at most 16*WORDLENGTH
+ * @param e a multi-precission exponent of at most k*m bits
+ * @param e_length the wordlength of the multi-precission exponent
+ * @return 1 on success 0 if the parameters do not cover e
+ */
+int mod_exp_p_192_split(uint16_t * A, split_pool_t * pool, uint16_t * bases, int k, int m, uint16_t * e, uint16_t e_length);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_ARITH_P192_SPLIT_H */
+
@@ -0,0 +1,343 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_conv.h"
+
+/*
+ * On x86 hosts the limb array of an element is, byte for byte, its big-endian
+ * octet string reversed, so whole 16-byte blocks are converted with a single
+ * byte shuffle. The MSP430 and other targets take the word by word path.
+ */
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define M_CONV_SSSE3
+#endif
+
+static const char hex_digits[] = "0123456789abcdef";
+
+static int hex_value(char c) {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F')) {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+#ifdef M_CONV_SSSE3
+static __m128i reverse_mask(void) {
+    return _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+}
+
+//Reverses the low 8 bytes only, for the tail of 12-word elements
+static __m128i reverse_mask_8(void) {
+    return _mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 0, 1, 2, 3, 4, 5, 6, 7);
+}
+
+/*
+ * 16 hex characters to their 8 nibble pairs, in the low half of the result.
+ * valid is cleared on a bad character
+ */
+static __m128i hex16_to_bytes(const char * in, int * valid) {
+    __m128i c = _mm_loadu_si128((const __m128i *) in);
+    __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+            _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+            _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+    __m128i nibbles = _mm_or_si128(
+            _mm_and_si128(is_digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+            _mm_and_si128(is_letter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+    if (0xFFFF != _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter))) {
+        *valid = 0;
+    }
+    //16*high + low for every pair of characters
+    return _mm_maddubs_epi16(nibbles, _mm_set1_epi16(0x0110));
+}
+
+/*
+ * 16 octets to 32 hex characters, or the low 8 to 16 if half is set
+ */
+static void bytes16_to_hex(char * out, __m128i b, int half) {
+    __m128i lut = _mm_loadu_si128((const __m128i *) hex_digits);
+    __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(b, 4), mask));
+    __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(b, mask));
+
+    _mm_storeu_si128((__m128i *) out, _mm_unpacklo_epi8(hi, lo));
+    if (0 == half) {
+        _mm_storeu_si128((__m128i *) (out + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+}
+#endif
+
+/*
+ * Full width conversion, exactly 2*wordlength octets
+ */
+static void octets_to_limbs(uint16_t * out, uint8_t wordlength, const uint8_t * in) {
+    size_t len = 2 * (size_t) wordlength;
+    size_t k = 0;
+    int i;
+
+#ifdef M_CONV_SSSE3
+    //The last 16 octets are the least significant
+    for (; k + 16 <= len; k += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *) (in + len - 16 - k));
+        _mm_storeu_si128((__m128i *) ((uint8_t *) out + k), _mm_shuffle_epi8(b, reverse_mask()));
+    }
+    if (k + 8 <= len) {
+        __m128i b = _mm_loadl_epi64((const __m128i *) (in + len - 8 - k));
+        _mm_storel_epi64((__m128i *) ((uint8_t *) out + k), _mm_shuffle_epi8(b, reverse_mask_8()));
+        k += 8;
+    }
+#endif
+    for (i = (int) (k / 2); i < wordlength; i++) {
+        out[i] = (uint16_t) ((((uint16_t) in[len - 2 - 2 * i]) << 8) | in[len - 1 - 2 * i]);
+    }
+}
+
+static void limbs_to_octets(uint8_t * out, const uint16_t * in, uint8_t wordlength) {
+    size_t len = 2 * (size_t) wordlength;
+    size_t k = 0;
+    int i;
+
+#ifdef M_CONV_SSSE3
+    for (; k + 16 <= len; k += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *) ((const uint8_t *) in + k));
+        _mm_storeu_si128((__m128i *) (out + len - 16 - k), _mm_shuffle_epi8(b, reverse_mask()));
+    }
+    if (k + 8 <= len) {
+        __m128i b = _mm_loadl_epi64((const __m128i *) ((const uint8_t *) in + k));
+        _mm_storel_epi64((__m128i *) (out + len - 8 - k), _mm_shuffle_epi8(b, reverse_mask_8()));
+        k += 8;
+    }
+#endif
+    for (i = (int) (k / 2); i < wordlength; i++) {
+        out[len - 2 - 2 * i] = (uint8_t) (in[i] >> 8);
+        out[len - 1 - 2 * i] = (uint8_t) in[i];
+    }
+}
+
+/*
+ * Full width conversion, exactly 4*wordlength characters
+ */
+static int hex_to_limbs(uint16_t * out, uint8_t wordlength, const char * in) {
+    size_t len = 4 * (size_t) wordlength;
+    size_t k = 0;
+    int valid = 1;
+    int d0, d1, d2, d3;
+    int i;
+
+#ifdef M_CONV_SSSE3
+    //32 characters make 16 octets, the last ones the least significant
+    for (; k + 32 <= len; k += 32) {
+        __m128i high = hex16_to_bytes(in + len - 32 - k, &valid);
+        __m128i low = hex16_to_bytes(in + len - 16 - k, &valid);
+        __m128i b = _mm_packus_epi16(high, low);
+        _mm_storeu_si128((__m128i *) ((uint8_t *) out + k / 2), _mm_shuffle_epi8(b, reverse_mask()));
+    }
+    if (k + 16 <= len) {
+        __m128i b = _mm_packus_epi16(hex16_to_bytes(in + len - 16 - k, &valid), _mm_setzero_si128());
+        _mm_storel_epi64((__m128i *) ((uint8_t *) out + k / 2), _mm_shuffle_epi8(b, reverse_mask_8()));
+        k += 16;
+    }
+#endif
+    for (i = (int) (k / 4); i < wordlength; i++) {
+        d0 = hex_value(in[len - 4 - 4 * i]);
+        d1 = hex_value(in[len - 3 - 4 * i]);
+        d2 = hex_value(in[len - 2 - 4 * i]);
+        d3 = hex_value(in[len - 1 - 4 * i]);
+        if ((d0 | d1 | d2 | d3) < 0) {
+            return 0;
+        }
+        out[i] = (uint16_t) ((d0 << 12) | (d1 << 8) | (d2 << 4) | d3);
+    }
+    return valid;
+}
+
+static void limbs_to_hex(char * out, const uint16_t * in, uint8_t wordlength) {
+    size_t len = 4 * (size_t) wordlength;
+    size_t k = 0;
+    int i;
+
+#ifdef M_CONV_SSSE3
+    for (; k + 32 <= len; k += 32) {
+        __m128i b = _mm_loadu_si128((const __m128i *) ((const uint8_t *) in + k / 2));
+        bytes16_to_hex(out + len - 32 - k, _mm_shuffle_epi8(b, reverse_mask()), 0);
+    }
+    if (k + 16 <= len) {
+        __m128i b = _mm_loadl_epi64((const __m128i *) ((const uint8_t *) in + k / 2));
+        bytes16_to_hex(out + len - 16 - k, _mm_shuffle_epi8(b, reverse_mask_8()), 1);
+        k += 16;
+    }
+#endif
+    for (i = (int) (k / 4); i < wordlength; i++) {
+        out[len - 4 - 4 * i] = hex_digits[(in[i] >> 12) & 0xF];
+        out[len - 3 - 4 * i] = hex_digits[(in[i] >> 8) & 0xF];
+        out[len - 2 - 4 * i] = hex_digits[(in[i] >> 4) & 0xF];
+        out[len - 1 - 4 * i] = hex_digits[in[i] & 0xF];
+    }
+}
+
+/**
+ * Big-endian octet string to limbs c.f. SEC 1 Sect. 2.3.8
+ */
+int mp_from_octets(uint16_t * M_RESTRICT out, uint8_t wordlength, const uint8_t * in, size_t len) {
+    size_t full = 2 * (size_t) wordlength;
+    size_t j;
+
+    if (len >= full) {
+        for (j = 0; j < len - full; j++) {
+            if (0 != in[j]) {
+                return 0;
+            }
+        }
+        octets_to_limbs(out, wordlength, in + len - full);
+        return 1;
+    }
+    //Short strings, octet j from the end goes to word j/2
+    set_to_zero(out, wordlength);
+    for (j = 0; j < len; j++) {
+        out[j / 2] |= (uint16_t) (((uint16_t) in[len - 1 - j]) << (8 * (j % 2)));
+    }
+    return 1;
+}
+
+/**
+ * Limbs to a big-endian octet string of len octets c.f. SEC 1 Sect. 2.3.7
+ */
+int mp_to_octets(uint8_t * M_RESTRICT out, size_t len, const uint16_t * in, uint8_t wordlength) {
+    size_t full = 2 * (size_t) wordlength;
+    size_t j;
+
+    if (len >= full) {
+        for (j = 0; j < len - full; j++) {
+            out[j] = 0;
+        }
+        limbs_to_octets(out + len - full, in, wordlength);
+        return 1;
+    }
+    for (j = len; j < full; j++) {
+        if (0 != (uint8_t) (in[j / 2] >> (8 * (j % 2)))) {
+            return 0;
+        }
+    }
+    for (j = 0; j < len; j++) {
+        out[len - 1 - j] = (uint8_t) (in[j / 2] >> (8 * (j % 2)));
+    }
+    return 1;
+}
+
+/**
+ * Big-endian hex string of len characters (no prefix, either case) to limbs
+ */
+int mp_from_hex(uint16_t * M_RESTRICT out, uint8_t wordlength, const char * in, size_t len) {
+    size_t full = 4 * (size_t) wordlength;
+    size_t j;
+    int nibble;
+
+    if (len >= full) {
+        for (j = 0; j < len - full; j++) {
+            if ('0' != in[j]) {
+                return 0;
+            }
+        }
+        return hex_to_limbs(out, wordlength, in + len - full);
+    }
+    set_to_zero(out, wordlength);
+    for (j = 0; j < len; j++) {
+        nibble = hex_value(in[len - 1 - j]);
+        if (nibble < 0) {
+            return 0;
+        }
+        out[j / 4] |= (uint16_t) (nibble << (4 * (j % 4)));
+    }
+    return 1;
+}
+
+/**
+ * Limbs to exactly 4*wordlength lowercase hex characters, most significant
+ * first. No terminator is written.
+ */
+void mp_to_hex(char * M_RESTRICT out, const uint16_t * in, uint8_t wordlength) {
+    limbs_to_hex(out, in, wordlength);
+}
+
+/**
+ * n elements of 2*wordlength octets each, back to back, to n consecutive
+ * elements of wordlength words
+ */
+void mp_from_octets_n(uint16_t * M_RESTRICT out, uint8_t wordlength, const uint8_t * in, size_t n) {
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        octets_to_limbs(out + i * wordlength, wordlength, in + 2 * i * wordlength);
+    }
+}
+
+/**
+ * n consecutive elements to n big-endian strings of 2*wordlength octets each
+ */
+void mp_to_octets_n(uint8_t * M_RESTRICT out, const uint16_t * in, uint8_t wordlength, size_t n) {
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        limbs_to_octets(out + 2 * i * wordlength, in + i * wordlength, wordlength);
+    }
+}
+
+/**
+ * n hex strings of 4*wordlength characters each, back to back, to n
+ * consecutive elements. Returns 1 on success 0 on a bad character
+ */
+int mp_from_hex_n(uint16_t * M_RESTRICT out, uint8_t wordlength, const char * in, size_t n) {
+    size_t i;
+    int valid = 1;
+
+    for (i = 0; i < n; i++) {
+        valid &= hex_to_limbs(out + i * wordlength, wordlength, in + 4 * i * wordlength);
+    }
+    return valid;
+}
+
+/**
+ * n consecutive elements to n hex strings of 4*wordlength characters each,
+ * back to back and without terminators
+ */
+void mp_to_hex_n(char * M_RESTRICT out, const uint16_t * in, uint8_t wordlength, size_t n) {
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        limbs_to_hex(out + 4 * i * wordlength, in + i * wordlength, wordlength);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * File:   m_conv.h
+ *
+ * Conversion between the limb format (A[0] least significant word) and the
+ * big-endian octet strings and hex strings found on the wire.
+ */
+
+#ifndef M_CONV_H
+#define	M_CONV_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+
+// The conversions do not work in place, their outputs are M_RESTRICT.
+
+/**
+ * Big-endian octet string to limbs c.f. SEC 1 Sect. 2.3.8
+ * Input: len octets, leading octets past 2*wordlength must be zero
+ * Output: out, wordlength words
+ * Returns 1 on success 0 if the value does not fit
+ */
+int mp_from_octets(uint16_t * M_RESTRICT out, uint8_t wordlength, const uint8_t * in, size_t len);
+
+/**
+ * Limbs to a big-endian octet string of len octets c.f. SEC 1 Sect. 2.3.7
+ * Returns 1 on success 0 if the value does not fit in len octets
+ */
+int mp_to_octets(uint8_t * M_RESTRICT out, size_t len, const uint16_t * in, uint8_t wordlength);
+
+/**
+ * Big-endian hex string of len characters (no prefix, either case) to limbs
+ * Returns 1 on success 0 on a bad character or if the value does not fit
+ */
+int mp_from_hex(uint16_t * M_RESTRICT out, uint8_t wordlength, const char * in, size_t len);
+
+/**
+ * Limbs to exactly 4*wordlength lowercase hex characters, most significant
+ * first. No terminator is written.
+ */
+void mp_to_hex(char * M_RESTRICT out, const uint16_t * in, uint8_t wordlength);
+
+/**
+ * n elements of 2*wordlength octets each, back to back, to n consecutive
+ * elements of wordlength words
+ */
+void mp_from_octets_n(uint16_t * M_RESTRICT out, uint8_t wordlength, const uint8_t * in, size_t n);
+
+/**
+ * n consecutive elements to n big-endian strings of 2*wordlength octets each
+ */
+void mp_to_octets_n(uint8_t * M_RESTRICT out, const uint16_t * in, uint8_t wordlength, size_t n);
+
+/**
+ * n hex strings of 4*wordlength characters each, back to back, to n
+ * consecutive elements. Returns 1 on success 0 on a bad character
+ */
+int mp_from_hex_n(uint16_t * M_RESTRICT out, uint8_t wordlength, const char * in, size_t n);
+
+/**
+ * n consecutive elements to n hex strings of 4*wordlength characters each,
+ * back to back and without terminators
+ */
+void mp_to_hex_n(char * M_RESTRICT out, const uint16_t * in, uint8_t wordlength, size_t n);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_CONV_H */
+
@@ -18,6 +18,42 @@ extern "C" {
 // For now I'll restrict to work with numbers in [0,p-1] where p = p_192 with wordlength 12
 #define WORDLENGTH 12
 
+// Upper bound on the wordlength of a general (odd) modulus for the Montgomery
+// arithmetic in m_arith_mont.h. Hosts working with larger moduli raise it at
+// build time, e.g. -DMAX_WORDLENGTH=128 for 2048-bit RSA.
+#ifndef MAX_WORDLENGTH
+#define MAX_WORDLENGTH 24
+#endif
+
+// Width in bits of the sliding window used by mont_exp. Each extra bit doubles
+// the 2^{k-1} precomputed powers kept on the stack, 1 gives plain binary.
+#ifndef MONT_EXP_WINDOW
+#define MONT_EXP_WINDOW 4
+#endif
+
+// Width in bits of the fixed window used by mod_exp_p_192_ct, which keeps a
+// table of 2^k elements on the stack and scans all of it on every lookup.
+#ifndef CT_EXP_WINDOW
+#define CT_EXP_WINDOW 4
+#endif
+
+// Hosts with POSIX threads can run independent halves of a computation (e.g.
+// the two RSA-CRT exponentiations) concurrently.
+//#define M_USE_PTHREADS
+
+// Qualifier for the output of a function that cannot work in place, i.e.
+// whose output must not overlap any input. Every other entry point is
+// alias-safe: its output may be one of its inputs.
+#ifndef M_RESTRICT
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 199901L)
+#define M_RESTRICT restrict
+#elif defined(__GNUC__)
+#define M_RESTRICT __restrict__
+#else
+#define M_RESTRICT
+#endif
+#endif
+
 //#define	DEBUG_PRINTF
 
 #ifdef	__cplusplus
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_ec_p192.h"
+
+/*
+ * Using NIST prime p_192 = 2^{192} - 2^{64} -1
+ */
+static uint16_t p_192[WORDLENGTH] = {0xffff, 0xffff, 0xffff, 0xffff, 0xfffe, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+
+/*
+ * Curve coefficient b = 0x64210519 E59C80E7 0FA7E9AB 72243049 FEB8DEEC C146B9B1
+ */
+static uint16_t b_192[WORDLENGTH] = {0xb9b1, 0xc146, 0xdeec, 0xfeb8, 0x3049, 0x7224, 0xe9ab, 0x0fa7, 0x80e7, 0xe59c, 0x0519, 0x6421};
+
+static uint16_t three[WORDLENGTH] = {0x0003, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/**
+ * Point decompression c.f. SEC 1 Sect. 2.3.4
+ * Input: x \in [0,p-1] and the least significant bit of y
+ * Output: y such that (x,y) is on the curve
+ * Returns 1 if the point is valid 0 otherwise
+ */
+int decompress_point_p_192(uint16_t * y, uint16_t * x, uint8_t y_bit) {
+    uint16_t t[WORDLENGTH];
+
+    if (1 == compare_mp_elements(x, p_192, WORDLENGTH)) {
+        return 0;
+    }
+    //1. t = (x^2 - 3)*x + b
+    multiply_mod_p_192(t, x, x);
+    subtract_mod_p(t, t, three, p_192, WORDLENGTH);
+    multiply_mod_p_192(t, t, x);
+    add_mod_p(t, t, b_192, p_192, WORDLENGTH);
+    //2. y = sqrt(t)
+    if (0 == sqrt_mod_p_192(y, t)) {
+        return 0;
+    }
+    //3. Pick the root with the requested parity, y = 0 has no twin
+    if ((y[0] & 1) != (y_bit & 1)) {
+        if (mp_non_zero_words(y, WORDLENGTH) < 0) {
+            return 0;
+        }
+        subtract_mp_elements(y, p_192, y, WORDLENGTH);
+    }
+    return 1;
+}
+
+/**
+ * Decompresses n points. x and y hold n consecutive 12-word coordinates,
+ * valid[i] is set to the result of decompress_point_p_192 for the i-th point
+ * (valid may be NULL). Returns the number of valid points
+ */
+int decompress_points_p_192(uint16_t * y, uint16_t * x, uint8_t * y_bits, uint8_t * valid, int n) {
+    int count = 0;
+    int ok;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        ok = decompress_point_p_192(&y[WORDLENGTH * i], &x[WORDLENGTH * i], y_bits[i]);
+        if (NULL != valid) {
+            valid[i] = (uint8_t) ok;
+        }
+        count += ok;
+    }
+    return count;
+}
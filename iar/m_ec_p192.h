@@ -0,0 +1,36 @@
+/*
+ * File:   m_ec_p192.h
+ *
+ * Points of the NIST curve P-192, y^2 = x^3 - 3x + b over F_{p_192}.
+ */
+
+#ifndef M_EC_P192_H
+#define	M_EC_P192_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+/**
+ * Point decompression c.f. SEC 1 Sect. 2.3.4
+ * Input: x \in [0,p-1] and the least significant bit of y
+ * Output: y such that (x,y) is on the curve, y may be x
+ * Returns 1 if the point is valid 0 otherwise
+ */
+int decompress_point_p_192(uint16_t * y, uint16_t * x, uint8_t y_bit);
+
+/**
+ * Decompresses n points. x and y hold n consecutive 12-word coordinates,
+ * valid[i] is set to the result of decompress_point_p_192 for the i-th point
+ * (valid may be NULL).
+ * Returns the number of valid points
+ */
+int decompress_points_p_192(uint16_t * y, uint16_t * x, uint8_t * y_bits, uint8_t * valid, int n);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_EC_P192_H */
+
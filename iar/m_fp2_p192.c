@@ -0,0 +1,200 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_gcd.h"
+#include "m_fp2_p192.h"
+
+/*
+ * Using NIST prime p_192 = 2^{192} - 2^{64} -1
+ */
+static uint16_t p_192[WORDLENGTH] = {0xffff, 0xffff, 0xffff, 0xffff, 0xfffe, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+
+/*
+ * Products are kept unreduced in WIDE words and sums of two elements as
+ * WORDLENGTH words plus a carry, so that a whole F_{p^2} product costs two
+ * reductions.
+ */
+#define WIDE (2 * WORDLENGTH + 2)
+
+/**
+ * Reduction of an unreduced result modulo p_192
+ * Input: x of WIDE words, x < 2^{400}
+ * Output: c = x mod p
+ */
+static void reduce_wide(uint16_t * c, uint16_t * x) {
+    uint16_t y[2 * WORDLENGTH];
+    uint16_t h[2 * WORDLENGTH];
+
+    //1. x = L + H*2^{192} = L + H + H*2^{64} mod p, which is below p^2
+    copy_mp(y, x, WORDLENGTH);
+    set_to_zero(y + WORDLENGTH, WORDLENGTH);
+    set_to_zero(h, 2 * WORDLENGTH);
+    copy_mp(h, x + WORDLENGTH, WORDLENGTH + 2);
+    add_mp_elements(y, y, h, 2 * WORDLENGTH);
+    set_to_zero(h, 4);
+    copy_mp(h + 4, x + WORDLENGTH, WORDLENGTH + 2);
+    add_mp_elements(y, y, h, 2 * WORDLENGTH);
+    //2. Alg. 2.27
+    reduce_mod_p(y, p_192, c);
+}
+
+/**
+ * Full product t = a*b of WIDE words, a and b of WORDLENGTH words
+ */
+static void multiply_wide(uint16_t * t, uint16_t * a, uint16_t * b) {
+    multiply_mp_elements(t, a, b, WORDLENGTH);
+    t[2 * WORDLENGTH] = 0;
+    t[2 * WORDLENGTH + 1] = 0;
+}
+
+/**
+ * Product of two unreduced sums a + ca*2^{192} and b + cb*2^{192}, ca, cb
+ * \in {0,1}, with one WORDLENGTH multiplication
+ */
+static void multiply_sums(uint16_t * t, uint16_t * a, uint16_t ca, uint16_t * b, uint16_t cb) {
+    multiply_wide(t, a, b);
+    if (1 == ca) {
+        t[2 * WORDLENGTH] += add_mp_elements(t + WORDLENGTH, t + WORDLENGTH, b, WORDLENGTH);
+    }
+    if (1 == cb) {
+        t[2 * WORDLENGTH] += add_mp_elements(t + WORDLENGTH, t + WORDLENGTH, a, WORDLENGTH);
+    }
+    t[2 * WORDLENGTH] += ca & cb;
+}
+
+void add_fp2_p_192(uint16_t * c, uint16_t * a, uint16_t * b) {
+    add_mod_p(c, a, b, p_192, WORDLENGTH);
+    add_mod_p(c + WORDLENGTH, a + WORDLENGTH, b + WORDLENGTH, p_192, WORDLENGTH);
+}
+
+void subtract_fp2_p_192(uint16_t * c, uint16_t * a, uint16_t * b) {
+    subtract_mod_p(c, a, b, p_192, WORDLENGTH);
+    subtract_mod_p(c + WORDLENGTH, a + WORDLENGTH, b + WORDLENGTH, p_192, WORDLENGTH);
+}
+
+void conjugate_fp2_p_192(uint16_t * c, uint16_t * a) {
+    uint16_t zero[WORDLENGTH];
+
+    set_to_zero(zero, WORDLENGTH);
+    copy_mp(c, a, WORDLENGTH);
+    subtract_mod_p(c + WORDLENGTH, zero, a + WORDLENGTH, p_192, WORDLENGTH);
+}
+
+/**
+ * Karatsuba multiplication in F_{p^2}
+ * c0 = a0*b0 - a1*b1, c1 = (a0 + a1)(b0 + b1) - a0*b0 - a1*b1
+ */
+void multiply_fp2_p_192(uint16_t * c, uint16_t * a, uint16_t * b) {
+    uint16_t t0[WIDE];
+    uint16_t t1[WIDE];
+    uint16_t t2[WIDE];
+    uint16_t sa[WORDLENGTH];
+    uint16_t sb[WORDLENGTH];
+    uint16_t p_ext[WORDLENGTH + 2];
+    uint16_t ca, cb;
+
+    //1. Three products, the sums are not reduced
+    multiply_wide(t0, a, b);
+    multiply_wide(t1, a + WORDLENGTH, b + WORDLENGTH);
+    ca = add_mp_elements(sa, a, a + WORDLENGTH, WORDLENGTH);
+    cb = add_mp_elements(sb, b, b + WORDLENGTH, WORDLENGTH);
+    multiply_sums(t2, sa, ca, sb, cb);
+
+    //2. t2 = a0*b1 + a1*b0 < 2p^2
+    subtract_mp_elements(t2, t2, t0, WIDE);
+    subtract_mp_elements(t2, t2, t1, WIDE);
+
+    //3. t0 = a0*b0 - a1*b1, plus p*2^{192} if negative
+    if (1 == subtract_mp_elements(t0, t0, t1, WIDE)) {
+        copy_mp(p_ext, p_192, WORDLENGTH);
+        p_ext[WORDLENGTH] = 0;
+        p_ext[WORDLENGTH + 1] = 0;
+        add_mp_elements(t0 + WORDLENGTH, t0 + WORDLENGTH, p_ext, WORDLENGTH + 2);
+    }
+
+    //4. One reduction per coefficient
+    reduce_wide(c, t0);
+    reduce_wide(c + WORDLENGTH, t2);
+}
+
+/**
+ * Complex squaring in F_{p^2}
+ */
+void square_fp2_p_192(uint16_t * c, uint16_t * a) {
+    uint16_t t0[WIDE];
+    uint16_t t1[WIDE];
+    uint16_t s[WORDLENGTH];
+    uint16_t d[WORDLENGTH];
+    uint16_t cs, cd;
+
+    //1. s = a0 + a1, d = a0 + p - a1, both below 2p
+    cs = add_mp_elements(s, a, a + WORDLENGTH, WORDLENGTH);
+    cd = add_mp_elements(d, a, p_192, WORDLENGTH);
+    cd -= subtract_mp_elements(d, d, a + WORDLENGTH, WORDLENGTH);
+
+    //2. t0 = (a0 + a1)(a0 - a1), t1 = 2*a0*a1
+    multiply_sums(t0, s, cs, d, cd);
+    multiply_wide(t1, a, a + WORDLENGTH);
+    t1[2 * WORDLENGTH] = add_mp_elements(t1, t1, t1, 2 * WORDLENGTH);
+
+    reduce_wide(c, t0);
+    reduce_wide(c + WORDLENGTH, t1);
+}
+
+/**
+ * Norm map, one reduction for a0^2 + a1^2
+ */
+void norm_fp2_p_192(uint16_t * n, uint16_t * a) {
+    uint16_t t0[WIDE];
+    uint16_t t1[WIDE];
+
+    multiply_wide(t0, a, a);
+    multiply_wide(t1, a + WORDLENGTH, a + WORDLENGTH);
+    add_mp_elements(t0, t0, t1, WIDE);
+    reduce_wide(n, t0);
+}
+
+/**
+ * Inversion through the norm
+ */
+int inverse_fp2_p_192(uint16_t * c, uint16_t * a) {
+    uint16_t n[WORDLENGTH];
+    uint16_t n_inv[WORDLENGTH];
+    uint16_t a_bar[2 * WORDLENGTH];
+
+    //1. norm(a) = 0 only for a = 0, as -1 is not a square modulo p
+    norm_fp2_p_192(n, a);
+    if (0 == mp_inverse_mod(n_inv, n, p_192, WORDLENGTH)) {
+        return 0;
+    }
+    //2. c = conjugate(a) * norm(a)^{-1}
+    conjugate_fp2_p_192(a_bar, a);
+    multiply_mod_p_192(c, a_bar, n_inv);
+    multiply_mod_p_192(c + WORDLENGTH, a_bar + WORDLENGTH, n_inv);
+    return 1;
+}
@@ -0,0 +1,68 @@
+/*
+ * File:   m_fp2_p192.h
+ *
+ * Arithmetic in the quadratic extension F_{p^2} = F_p[i]/(i^2 + 1) of
+ * F_{p_192}. i^2 + 1 is irreducible since p_192 = 3 mod 4.
+ */
+
+#ifndef M_FP2_P192_H
+#define	M_FP2_P192_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+/*
+ * An element a0 + a1*i takes 2*WORDLENGTH words, a0 in words 0-11 and a1 in
+ * words 12-23, both in [0,p-1]. Outputs may alias inputs.
+ */
+
+/**
+ * c = a + b
+ */
+void add_fp2_p_192(uint16_t * c, uint16_t * a, uint16_t * b);
+
+/**
+ * c = a - b
+ */
+void subtract_fp2_p_192(uint16_t * c, uint16_t * a, uint16_t * b);
+
+/**
+ * c = a0 - a1*i, the conjugate of a
+ */
+void conjugate_fp2_p_192(uint16_t * c, uint16_t * a);
+
+/**
+ * Multiplication with three multiplications in F_p (Karatsuba) and
+ * two reductions modulo p
+ * Output: c = a * b
+ */
+void multiply_fp2_p_192(uint16_t * c, uint16_t * a, uint16_t * b);
+
+/**
+ * Squaring with two multiplications in F_p,
+ * (a0 + a1*i)^2 = (a0 + a1)(a0 - a1) + 2*a0*a1*i
+ * Output: c = a^2
+ */
+void square_fp2_p_192(uint16_t * c, uint16_t * a);
+
+/**
+ * Norm map to F_p, n = a * conjugate(a) = a0^2 + a1^2 (WORDLENGTH words)
+ */
+void norm_fp2_p_192(uint16_t * n, uint16_t * a);
+
+/**
+ * Inversion through the norm, a^{-1} = conjugate(a) / norm(a), with a
+ * single inversion in F_p
+ * Output: c = a^{-1}
+ * Returns 1 on success 0 if a = 0
+ */
+int inverse_fp2_p_192(uint16_t * c, uint16_t * a);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_FP2_P192_H */
+
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_gcd.h"
+
+/**
+ * a = a >> k
+ */
+static void shift_right(uint16_t * a, uint8_t wordlength, int k) {
+    int words = k / 16;
+    int bits = k - 16 * words;
+    int i;
+
+    for (i = 0; i + words + 1 < wordlength; i++) {
+        a[i] = (uint16_t) ((((uint32_t) a[i + words + 1] << 16) | a[i + words]) >> bits);
+    }
+    if (i + words < wordlength) {
+        a[i] = (uint16_t) (a[i + words] >> bits);
+        i++;
+    }
+    for (; i < wordlength; i++) {
+        a[i] = 0;
+    }
+}
+
+/**
+ * Multiplication by a 32-bit word
+ * Output: c = a*u of wordlength+2 words
+ */
+static void multiply_u32(uint16_t * c, uint16_t * a, uint8_t wordlength, uint32_t u) {
+    uint64_t uv = 0;
+    int i;
+
+    for (i = 0; i < wordlength; i++) {
+        uv = ((uint64_t) a[i]) * u + (uv >> 16);
+        c[i] = (uint16_t) uv;
+    }
+    uv >>= 16;
+    c[wordlength] = (uint16_t) uv;
+    c[wordlength + 1] = (uint16_t) (uv >> 16);
+}
+
+/**
+ * c = |P*x + Q*y| for cofactors P, Q of opposite signs, truncated to wordlength words
+ */
+static void combine_remainders(uint16_t * c, int64_t P, int64_t Q, uint16_t * x, uint16_t * y, uint8_t wordlength) {
+    uint16_t px[MAX_WORDLENGTH + 2];
+    uint16_t qy[MAX_WORDLENGTH + 2];
+
+    multiply_u32(px, x, wordlength, (uint32_t) ((P < 0) ? -P : P));
+    multiply_u32(qy, y, wordlength, (uint32_t) ((Q < 0) ? -Q : Q));
+    if ((P > 0) || (Q < 0)) {
+        subtract_mp_elements(px, px, qy, wordlength + 2);
+        copy_mp(c, px, wordlength);
+    } else {
+        subtract_mp_elements(qy, qy, px, wordlength + 2);
+        copy_mp(c, qy, wordlength);
+    }
+}
+
+/**
+ * c = |P|*x + |Q|*y truncated to wordlength words. The cofactors of a have
+ * alternating signs, so this is the magnitude of P*x + Q*y for signed x, y.
+ */
+static void combine_cofactors(uint16_t * c, int64_t P, int64_t Q, uint16_t * x, uint16_t * y, uint8_t wordlength) {
+    uint16_t px[MAX_WORDLENGTH + 2];
+    uint16_t qy[MAX_WORDLENGTH + 2];
+
+    multiply_u32(px, x, wordlength, (uint32_t) ((P < 0) ? -P : P));
+    multiply_u32(qy, y, wordlength, (uint32_t) ((Q < 0) ? -Q : Q));
+    add_mp_elements(c, px, qy, wordlength);
+}
+
+/**
+ * Jacobi symbol (a/n) by the binary algorithm
+ */
+int jacobi(uint16_t * a, uint16_t * n, uint8_t wordlength) {
+    uint16_t x[MAX_WORDLENGTH];
+    uint16_t y[MAX_WORDLENGTH];
+    uint16_t * pa = x;
+    uint16_t * pn = y;
+    uint16_t * tmp;
+    int t = 1;
+    int len = wordlength;
+    int i, k;
+
+    //1. a mod n, the only division
+    if (0 == divide_mp_elements(NULL, x, a, wordlength, n, wordlength)) {
+        return 0;
+    }
+    copy_mp(y, n, wordlength);
+
+    while (mp_non_zero_words(pa, len) >= 0) {
+        //2. (2/n) = -1 iff n = 3, 5 mod 8
+        i = 0;
+        while (0 == pa[i]) {
+            i++;
+        }
+        k = 16 * i;
+        while (0 == ((pa[i] >> (k - 16 * i)) & 1)) {
+            k++;
+        }
+        if (k > 0) {
+            shift_right(pa, len, k);
+            if ((1 == (k & 1)) && ((3 == (pn[0] & 7)) || (5 == (pn[0] & 7)))) {
+                t = -t;
+            }
+        }
+        //3. Quadratic reciprocity for odd a < n
+        if (0 == compare_mp_elements(pa, pn, len)) {
+            tmp = pa;
+            pa = pn;
+            pn = tmp;
+            if ((3 == (pa[0] & 3)) && (3 == (pn[0] & 3))) {
+                t = -t;
+            }
+        }
+        //4. (a/n) = ((a-n)/n), a-n is even
+        subtract_mp_elements(pa, pa, pn, len);
+        //4.1 Both only shrink, drop the common leading zero words
+        while ((len > 1) && (0 == pa[len - 1]) && (0 == pn[len - 1])) {
+            len--;
+        }
+    }
+
+    //5. gcd(a, n) = n
+    if ((1 == pn[0]) && (mp_non_zero_words(pn, len) <= 0)) {
+        return t;
+    }
+    return 0;
+}
+
+/**
+ * Extended Euclidean algorithm with Lehmer's acceleration
+ */
+void mp_gcd_ext(uint16_t * g, uint16_t * x, uint16_t * a, uint16_t * m, uint8_t wordlength) {
+    // u = r_i, v = r_{i+1} and |s_i|, |s_{i+1}| with r_i = s_i*a mod m.
+    // s_i > 0 for odd i and s_i <= 0 for even i.
+    uint16_t u[MAX_WORDLENGTH];
+    uint16_t v[MAX_WORDLENGTH];
+    uint16_t s0[MAX_WORDLENGTH];
+    uint16_t s1[MAX_WORDLENGTH];
+    uint16_t t0[MAX_WORDLENGTH];
+    uint16_t t1[MAX_WORDLENGTH];
+    uint16_t q[MAX_WORDLENGTH];
+    uint16_t qs[2 * MAX_WORDLENGTH];
+    int64_t A, B, C, D, T, uh, vh, qh;
+    int shift;
+    int parity = 0;
+    int steps;
+
+    //1. r_0 = m, r_1 = a mod m
+    copy_mp(u, m, wordlength);
+    divide_mp_elements(NULL, v, a, wordlength, m, wordlength);
+    set_to_zero(s0, wordlength);
+    set_to_zero(s1, wordlength);
+    s1[0] = 1;
+
+    while (mp_non_zero_words(v, wordlength) >= 0) {
+        //2. Quotients of the leading 32 bits, valid while both estimates agree
+        shift = mp_bit_length(u, wordlength) - 31;
+        if (shift < 0) {
+            shift = 0;
+        }
+        uh = (int64_t) (mp_bits(u, wordlength, shift, 16) | (((uint32_t) mp_bits(u, wordlength, shift + 16, 16)) << 16));
+        vh = (int64_t) (mp_bits(v, wordlength, shift, 16) | (((uint32_t) mp_bits(v, wordlength, shift + 16, 16)) << 16));
+        A = 1;
+        B = 0;
+        C = 0;
+        D = 1;
+        steps = 0;
+        while ((vh + C > 0) && (vh + D > 0) && (uh + A >= 0) && (uh + B >= 0)) {
+            qh = (uh + A) / (vh + C);
+            if (qh != (uh + B) / (vh + D)) {
+                break;
+            }
+            T = A - qh * C;
+            A = C;
+            C = T;
+            T = B - qh * D;
+            B = D;
+            D = T;
+            T = uh - qh * vh;
+            uh = vh;
+            vh = T;
+            steps++;
+        }
+
+        if (0 == steps) {
+            //3. No step could be made on the approximations, divide
+            divide_mp_elements(q, t0, u, wordlength, v, wordlength);
+            multiply_mp_elements(qs, q, s1, wordlength);
+            add_mp_elements(t1, qs, s0, wordlength);
+            copy_mp(u, v, wordlength);
+            copy_mp(v, t0, wordlength);
+            copy_mp(s0, s1, wordlength);
+            copy_mp(s1, t1, wordlength);
+            parity ^= 1;
+        } else {
+            //4. (u, v) = (A*u + B*v, C*u + D*v), likewise for the cofactors
+            combine_remainders(t0, A, B, u, v, wordlength);
+            combine_remainders(t1, C, D, u, v, wordlength);
+            copy_mp(u, t0, wordlength);
+            copy_mp(v, t1, wordlength);
+            combine_cofactors(t0, A, B, s0, s1, wordlength);
+            combine_cofactors(t1, C, D, s0, s1, wordlength);
+            copy_mp(s0, t0, wordlength);
+            copy_mp(s1, t1, wordlength);
+            parity ^= steps & 1;
+        }
+    }
+
+    //5. g = r_k = s_k*a, negative s_k are returned as m - |s_k|. g is
+    // written last as it may be m.
+    if (NULL != x) {
+        if ((1 == parity) || (mp_non_zero_words(s0, wordlength) < 0)) {
+            copy_mp(x, s0, wordlength);
+        } else {
+            subtract_mp_elements(x, m, s0, wordlength);
+        }
+    }
+    copy_mp(g, u, wordlength);
+}
+
+/**
+ * Inversion modulo m
+ */
+int mp_inverse_mod(uint16_t * x, uint16_t * a, uint16_t * m, uint8_t wordlength) {
+    uint16_t g[MAX_WORDLENGTH];
+
+    mp_gcd_ext(g, x, a, m, wordlength);
+    if ((1 == g[0]) && (mp_non_zero_words(g, wordlength) <= 0)) {
+        return 1;
+    }
+    return 0;
+}
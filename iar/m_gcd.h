@@ -0,0 +1,47 @@
+/*
+ * File:   m_gcd.h
+ *
+ * Greatest common divisors, modular inverses and the Jacobi symbol for
+ * multiprecision integers of any wordlength up to MAX_WORDLENGTH.
+ */
+
+#ifndef M_GCD_H
+#define	M_GCD_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+/**
+ * Jacobi symbol (a/n) by the binary algorithm, no divisions after the
+ * initial reduction of a modulo n
+ * Input: n odd, n > 0, wordlength <= MAX_WORDLENGTH
+ * Returns 1, -1, or 0 if gcd(a, n) > 1. For a prime n this is the Legendre symbol
+ */
+int jacobi(uint16_t * a, uint16_t * n, uint8_t wordlength);
+
+/**
+ * Extended Euclidean algorithm with Lehmer's acceleration c.f. Knuth TAOCP
+ * Vol. 2 Alg. 4.5.2 L. Most quotient steps are taken on 32-bit leading
+ * approximations and applied to the full numbers in one matrix step.
+ * Input: m > 0, wordlength <= MAX_WORDLENGTH
+ * Output: g = gcd(a, m) and x \in [0,m-1] with a*x = g mod m, x may be NULL.
+ * g and x may each be a or m
+ */
+void mp_gcd_ext(uint16_t * g, uint16_t * x, uint16_t * a, uint16_t * m, uint8_t wordlength);
+
+/**
+ * Inversion modulo m
+ * Input: m > 1, wordlength <= MAX_WORDLENGTH
+ * Output: x = a^{-1} mod m
+ * Returns 1 if a is invertible modulo m 0 otherwise
+ */
+int mp_inverse_mod(uint16_t * x, uint16_t * a, uint16_t * m, uint8_t wordlength);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_GCD_H */
+
@@ -0,0 +1,258 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_gf2m.h"
+
+/*
+ * Carry-less multiplication is a single instruction on x86-64 hosts with
+ * PCLMULQDQ, on 64-bit limbs. The limb array of an element is, byte for
+ * byte, its array of 64-bit limbs on these little-endian hosts.
+ */
+#if defined(__PCLMUL__) && defined(__x86_64__)
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define M_GF2M_PCLMUL
+#endif
+
+#if GF2M_COMB_WORDS < 2 * GF2M_MAX_WORDLENGTH + 2 * (GF2M_MAX_WORDLENGTH + 1)
+#error "GF2M_COMB_WORDS must leave room for 1-bit windows in the largest field"
+#endif
+
+const gf2m_field_t gf2m_f163 = {163, {7, 6, 3}, 3, 11};
+const gf2m_field_t gf2m_f233 = {233, {74, 0, 0}, 1, 15};
+const gf2m_field_t gf2m_f283 = {283, {12, 7, 5}, 3, 18};
+const gf2m_field_t gf2m_f409 = {409, {87, 0, 0}, 1, 26};
+const gf2m_field_t gf2m_f571 = {571, {10, 5, 2}, 3, 36};
+
+/*
+ * Bits of a byte spread to the even positions of a word, the square of the
+ * byte as a polynomial
+ */
+static const uint16_t square_table[256] = {
+    0x0000, 0x0001, 0x0004, 0x0005, 0x0010, 0x0011, 0x0014, 0x0015,
+    0x0040, 0x0041, 0x0044, 0x0045, 0x0050, 0x0051, 0x0054, 0x0055,
+    0x0100, 0x0101, 0x0104, 0x0105, 0x0110, 0x0111, 0x0114, 0x0115,
+    0x0140, 0x0141, 0x0144, 0x0145, 0x0150, 0x0151, 0x0154, 0x0155,
+    0x0400, 0x0401, 0x0404, 0x0405, 0x0410, 0x0411, 0x0414, 0x0415,
+    0x0440, 0x0441, 0x0444, 0x0445, 0x0450, 0x0451, 0x0454, 0x0455,
+    0x0500, 0x0501, 0x0504, 0x0505, 0x0510, 0x0511, 0x0514, 0x0515,
+    0x0540, 0x0541, 0x0544, 0x0545, 0x0550, 0x0551, 0x0554, 0x0555,
+    0x1000, 0x1001, 0x1004, 0x1005, 0x1010, 0x1011, 0x1014, 0x1015,
+    0x1040, 0x1041, 0x1044, 0x1045, 0x1050, 0x1051, 0x1054, 0x1055,
+    0x1100, 0x1101, 0x1104, 0x1105, 0x1110, 0x1111, 0x1114, 0x1115,
+    0x1140, 0x1141, 0x1144, 0x1145, 0x1150, 0x1151, 0x1154, 0x1155,
+    0x1400, 0x1401, 0x1404, 0x1405, 0x1410, 0x1411, 0x1414, 0x1415,
+    0x1440, 0x1441, 0x1444, 0x1445, 0x1450, 0x1451, 0x1454, 0x1455,
+    0x1500, 0x1501, 0x1504, 0x1505, 0x1510, 0x1511, 0x1514, 0x1515,
+    0x1540, 0x1541, 0x1544, 0x1545, 0x1550, 0x1551, 0x1554, 0x1555,
+    0x4000, 0x4001, 0x4004, 0x4005, 0x4010, 0x4011, 0x4014, 0x4015,
+    0x4040, 0x4041, 0x4044, 0x4045, 0x4050, 0x4051, 0x4054, 0x4055,
+    0x4100, 0x4101, 0x4104, 0x4105, 0x4110, 0x4111, 0x4114, 0x4115,
+    0x4140, 0x4141, 0x4144, 0x4145, 0x4150, 0x4151, 0x4154, 0x4155,
+    0x4400, 0x4401, 0x4404, 0x4405, 0x4410, 0x4411, 0x4414, 0x4415,
+    0x4440, 0x4441, 0x4444, 0x4445, 0x4450, 0x4451, 0x4454, 0x4455,
+    0x4500, 0x4501, 0x4504, 0x4505, 0x4510, 0x4511, 0x4514, 0x4515,
+    0x4540, 0x4541, 0x4544, 0x4545, 0x4550, 0x4551, 0x4554, 0x4555,
+    0x5000, 0x5001, 0x5004, 0x5005, 0x5010, 0x5011, 0x5014, 0x5015,
+    0x5040, 0x5041, 0x5044, 0x5045, 0x5050, 0x5051, 0x5054, 0x5055,
+    0x5100, 0x5101, 0x5104, 0x5105, 0x5110, 0x5111, 0x5114, 0x5115,
+    0x5140, 0x5141, 0x5144, 0x5145, 0x5150, 0x5151, 0x5154, 0x5155,
+    0x5400, 0x5401, 0x5404, 0x5405, 0x5410, 0x5411, 0x5414, 0x5415,
+    0x5440, 0x5441, 0x5444, 0x5445, 0x5450, 0x5451, 0x5454, 0x5455,
+    0x5500, 0x5501, 0x5504, 0x5505, 0x5510, 0x5511, 0x5514, 0x5515,
+    0x5540, 0x5541, 0x5544, 0x5545, 0x5550, 0x5551, 0x5554, 0x5555
+};
+
+/**
+ * t = t + T*z^pos
+ */
+static void xor_shifted(uint16_t * t, uint16_t T, int pos) {
+    int word = pos >> 4;
+    int shift = pos & 15;
+
+    t[word] ^= (uint16_t) (T << shift);
+    if (0 != shift) {
+        t[word + 1] ^= (uint16_t) (T >> (16 - shift));
+    }
+}
+
+void gf2m_add(uint16_t * c, uint16_t * a, uint16_t * b, const gf2m_field_t * f) {
+    int i;
+
+    for (i = 0; i < f->wordlength; i++) {
+        c[i] = a[i] ^ b[i];
+    }
+}
+
+/**
+ * Reduction modulo f(z), z^m = z^k[0] + ... + 1
+ */
+void gf2m_reduce(uint16_t * c, uint16_t * t, const gf2m_field_t * f) {
+    int top = f->m >> 4;
+    uint16_t T;
+    int i, j;
+
+    //1. Whole words above z^m, every term lands at least 16 bits lower
+    for (i = 2 * f->wordlength - 1; i > top; i--) {
+        T = t[i];
+        if (0 != T) {
+            t[i] = 0;
+            xor_shifted(t, T, 16 * i - f->m);
+            for (j = 0; j < f->terms; j++) {
+                xor_shifted(t, T, 16 * i - f->m + f->k[j]);
+            }
+        }
+    }
+    //2. The bits of the top word from z^m on
+    T = t[top] >> (f->m & 15);
+    t[top] &= (uint16_t) ((1U << (f->m & 15)) - 1);
+    t[0] ^= T;
+    for (j = 0; j < f->terms; j++) {
+        xor_shifted(t, T, f->k[j]);
+    }
+    copy_mp(c, t, f->wordlength);
+}
+
+#ifdef M_GF2M_PCLMUL
+/**
+ * t = a*b of 2*wordlength words, schoolbook on 64-bit limbs
+ */
+static void multiply_clmul(uint16_t * t, uint16_t * a, uint16_t * b, int wordlength) {
+    uint64_t a64[(GF2M_MAX_WORDLENGTH + 3) / 4];
+    uint64_t b64[(GF2M_MAX_WORDLENGTH + 3) / 4];
+    uint64_t t64[2 * ((GF2M_MAX_WORDLENGTH + 3) / 4)];
+    __m128i ai, p;
+    int n = (wordlength + 3) / 4;
+    int i, j;
+
+    memset(a64, 0, sizeof(a64));
+    memset(b64, 0, sizeof(b64));
+    memset(t64, 0, sizeof(t64));
+    memcpy(a64, a, 2 * wordlength);
+    memcpy(b64, b, 2 * wordlength);
+    for (i = 0; i < n; i++) {
+        ai = _mm_cvtsi64_si128((long long) a64[i]);
+        for (j = 0; j < n; j++) {
+            p = _mm_clmulepi64_si128(ai, _mm_cvtsi64_si128((long long) b64[j]), 0x00);
+            t64[i + j] ^= (uint64_t) _mm_cvtsi128_si64(p);
+            t64[i + j + 1] ^= (uint64_t) _mm_cvtsi128_si64(_mm_srli_si128(p, 8));
+        }
+    }
+    memcpy(t, t64, 4 * wordlength);
+}
+#else
+/**
+ * Widest window of 4, 2 or 1 bits whose table and product fit in
+ * GF2M_COMB_WORDS words
+ */
+static int comb_window(int wordlength) {
+    int w = 4;
+
+    while ((w > 1) && ((1 << w) * (wordlength + 1) + 2 * wordlength > GF2M_COMB_WORDS)) {
+        w >>= 1;
+    }
+    return w;
+}
+
+/**
+ * t = a*b of 2*wordlength words by the left-to-right comb method with
+ * windows of w bits, w dividing 16. Bu holds the 2^w rows of the table,
+ * wordlength + 1 words each.
+ */
+static void multiply_comb(uint16_t * t, uint16_t * Bu, uint16_t * a, uint16_t * b, int wordlength, int w) {
+    //Row u is u(z)*b(z) for all u of degree < w
+    int row = wordlength + 1;
+    uint16_t mask = (uint16_t) ((1 << w) - 1);
+    uint16_t * Bv;
+    uint16_t u;
+    int i, j, k;
+
+    //1. Precomputation
+    set_to_zero(Bu, row);
+    copy_mp(Bu + row, b, wordlength);
+    Bu[row + wordlength] = 0;
+    for (u = 2; u <= mask; u++) {
+        Bv = Bu + u * row;
+        if (0 == (u & 1)) {
+            //Row u = z*row u/2
+            Bv[0] = (uint16_t) (Bu[(u >> 1) * row] << 1);
+            for (i = 1; i <= wordlength; i++) {
+                Bv[i] = (uint16_t) ((Bu[(u >> 1) * row + i] << 1) | (Bu[(u >> 1) * row + i - 1] >> 15));
+            }
+        } else {
+            for (i = 0; i <= wordlength; i++) {
+                Bv[i] = Bu[(u - 1) * row + i] ^ Bu[row + i];
+            }
+        }
+    }
+
+    //2. One window of every word of a per pass, from the top one
+    set_to_zero(t, 2 * wordlength);
+    for (k = 16 / w - 1; k >= 0; k--) {
+        for (j = 0; j < wordlength; j++) {
+            Bv = Bu + ((a[j] >> (w * k)) & mask) * row;
+            for (i = 0; i <= wordlength; i++) {
+                t[i + j] ^= Bv[i];
+            }
+        }
+        //2.1 t = t*z^w
+        if (0 != k) {
+            for (i = 2 * wordlength - 1; i > 0; i--) {
+                t[i] = (uint16_t) ((t[i] << w) | (t[i - 1] >> (16 - w)));
+            }
+            t[0] = (uint16_t) (t[0] << w);
+        }
+    }
+}
+#endif
+
+void gf2m_multiply(uint16_t * c, uint16_t * a, uint16_t * b, const gf2m_field_t * f) {
+#ifdef M_GF2M_PCLMUL
+    uint16_t t[2 * GF2M_MAX_WORDLENGTH];
+
+    multiply_clmul(t, a, b, f->wordlength);
+    gf2m_reduce(c, t, f);
+#else
+    //The product, then the table sized by the wordlength of the field
+    uint16_t t[GF2M_COMB_WORDS];
+
+    multiply_comb(t, t + 2 * f->wordlength, a, b, f->wordlength, comb_window(f->wordlength));
+    gf2m_reduce(c, t, f);
+#endif
+}
+
+void gf2m_square(uint16_t * c, uint16_t * a, const gf2m_field_t * f) {
+    uint16_t t[2 * GF2M_MAX_WORDLENGTH];
+    int i;
+
+    for (i = 0; i < f->wordlength; i++) {
+        t[2 * i] = square_table[a[i] & 0xFF];
+        t[2 * i + 1] = square_table[a[i] >> 8];
+    }
+    gf2m_reduce(c, t, f);
+}
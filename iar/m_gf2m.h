@@ -0,0 +1,86 @@
+/*
+ * File:   m_gf2m.h
+ *
+ * Arithmetic in the binary fields GF(2^m) of the NIST binary and Koblitz
+ * curves (B-163/K-163 to B-571/K-571) in polynomial basis. An element is a
+ * polynomial of degree < m stored in f->wordlength words, bit i of the limb
+ * array (bit i%16 of word i/16) being the coefficient of z^i.
+ */
+
+#ifndef M_GF2M_H
+#define	M_GF2M_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+// Wordlength of the largest field, m = 571
+#define GF2M_MAX_WORDLENGTH 36
+
+// Words of stack gf2m_multiply keeps for the product and the comb table,
+// 2*wordlength + 2^w*(wordlength + 1) for a window of w bits. Each field gets
+// the widest of 4, 2 and 1 bits that fits, the default fits 2 bits up to
+// B-283 and 1 bit for B-409 and B-571. 16*(GF2M_MAX_WORDLENGTH + 1) +
+// 2*GF2M_MAX_WORDLENGTH = 664 gives every field 4-bit windows.
+#ifndef GF2M_COMB_WORDS
+#define GF2M_COMB_WORDS (2 * GF2M_MAX_WORDLENGTH + 2 * (GF2M_MAX_WORDLENGTH + 1))
+#endif
+
+/**
+ * Reduction polynomial f(z) = z^m + z^k[0] + ... + z^k[terms-1] + 1, a
+ * trinomial (terms = 1) or a pentanomial (terms = 3)
+ */
+typedef struct {
+    uint16_t m;
+    uint16_t k[3];
+    uint8_t terms;
+    uint8_t wordlength; // ceil(m/16)
+} gf2m_field_t;
+
+// The fields of FIPS 186-3 Appendix D.1.3
+extern const gf2m_field_t gf2m_f163; // z^163 + z^7 + z^6 + z^3 + 1
+extern const gf2m_field_t gf2m_f233; // z^233 + z^74 + 1
+extern const gf2m_field_t gf2m_f283; // z^283 + z^12 + z^7 + z^5 + 1
+extern const gf2m_field_t gf2m_f409; // z^409 + z^87 + 1
+extern const gf2m_field_t gf2m_f571; // z^571 + z^10 + z^5 + z^2 + 1
+
+/*
+ * All outputs may alias inputs.
+ */
+
+/**
+ * Addition, c = a + b = a XOR b
+ */
+void gf2m_add(uint16_t * c, uint16_t * a, uint16_t * b, const gf2m_field_t * f);
+
+/**
+ * Reduction modulo f(z) c.f. Hankerson et al. Alg. 2.40, one word at a
+ * time from the top with shifted XORs for each term of f
+ * Input: t of 2*wordlength words, a polynomial of degree < 32*wordlength - 15
+ * Output: c = t mod f, t is overwritten
+ */
+void gf2m_reduce(uint16_t * c, uint16_t * t, const gf2m_field_t * f);
+
+/**
+ * Multiplication, c = a*b mod f. Uses the left-to-right comb method c.f.
+ * Hankerson et al. Alg. 2.36 with windows sized by GF2M_COMB_WORDS, or
+ * PCLMULQDQ on x86-64 hosts built with it enabled (e.g. -mpclmul).
+ * Worst-case stack: GF2M_COMB_WORDS words (292 bytes by default) of
+ * scratch, plus gf2m_reduce's frame.
+ */
+void gf2m_multiply(uint16_t * c, uint16_t * a, uint16_t * b, const gf2m_field_t * f);
+
+/**
+ * Squaring, c = a^2 mod f. Squaring is linear over GF(2), the bits of a are
+ * spread out with a 256-entry table c.f. Hankerson et al. Alg. 2.39.
+ * Worst-case stack: 2*GF2M_MAX_WORDLENGTH words (144 bytes) of scratch.
+ */
+void gf2m_square(uint16_t * c, uint16_t * a, const gf2m_field_t * f);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_GF2M_H */
+
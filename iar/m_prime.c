@@ -0,0 +1,276 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_mont.h"
+#include "m_prime.h"
+
+/*
+ * The first 512 odd primes
+ */
+static const uint16_t small_primes[512] = {
+    3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59,
+    61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131, 137,
+    139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223, 227,
+    229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311, 313,
+    317, 331, 337, 347, 349, 353, 359, 367, 373, 379, 383, 389, 397, 401, 409, 419,
+    421, 431, 433, 439, 443, 449, 457, 461, 463, 467, 479, 487, 491, 499, 503, 509,
+    521, 523, 541, 547, 557, 563, 569, 571, 577, 587, 593, 599, 601, 607, 613, 617,
+    619, 631, 641, 643, 647, 653, 659, 661, 673, 677, 683, 691, 701, 709, 719, 727,
+    733, 739, 743, 751, 757, 761, 769, 773, 787, 797, 809, 811, 821, 823, 827, 829,
+    839, 853, 857, 859, 863, 877, 881, 883, 887, 907, 911, 919, 929, 937, 941, 947,
+    953, 967, 971, 977, 983, 991, 997, 1009, 1013, 1019, 1021, 1031, 1033, 1039, 1049, 1051,
+    1061, 1063, 1069, 1087, 1091, 1093, 1097, 1103, 1109, 1117, 1123, 1129, 1151, 1153, 1163, 1171,
+    1181, 1187, 1193, 1201, 1213, 1217, 1223, 1229, 1231, 1237, 1249, 1259, 1277, 1279, 1283, 1289,
+    1291, 1297, 1301, 1303, 1307, 1319, 1321, 1327, 1361, 1367, 1373, 1381, 1399, 1409, 1423, 1427,
+    1429, 1433, 1439, 1447, 1451, 1453, 1459, 1471, 1481, 1483, 1487, 1489, 1493, 1499, 1511, 1523,
+    1531, 1543, 1549, 1553, 1559, 1567, 1571, 1579, 1583, 1597, 1601, 1607, 1609, 1613, 1619, 1621,
+    1627, 1637, 1657, 1663, 1667, 1669, 1693, 1697, 1699, 1709, 1721, 1723, 1733, 1741, 1747, 1753,
+    1759, 1777, 1783, 1787, 1789, 1801, 1811, 1823, 1831, 1847, 1861, 1867, 1871, 1873, 1877, 1879,
+    1889, 1901, 1907, 1913, 1931, 1933, 1949, 1951, 1973, 1979, 1987, 1993, 1997, 1999, 2003, 2011,
+    2017, 2027, 2029, 2039, 2053, 2063, 2069, 2081, 2083, 2087, 2089, 2099, 2111, 2113, 2129, 2131,
+    2137, 2141, 2143, 2153, 2161, 2179, 2203, 2207, 2213, 2221, 2237, 2239, 2243, 2251, 2267, 2269,
+    2273, 2281, 2287, 2293, 2297, 2309, 2311, 2333, 2339, 2341, 2347, 2351, 2357, 2371, 2377, 2381,
+    2383, 2389, 2393, 2399, 2411, 2417, 2423, 2437, 2441, 2447, 2459, 2467, 2473, 2477, 2503, 2521,
+    2531, 2539, 2543, 2549, 2551, 2557, 2579, 2591, 2593, 2609, 2617, 2621, 2633, 2647, 2657, 2659,
+    2663, 2671, 2677, 2683, 2687, 2689, 2693, 2699, 2707, 2711, 2713, 2719, 2729, 2731, 2741, 2749,
+    2753, 2767, 2777, 2789, 2791, 2797, 2801, 2803, 2819, 2833, 2837, 2843, 2851, 2857, 2861, 2879,
+    2887, 2897, 2903, 2909, 2917, 2927, 2939, 2953, 2957, 2963, 2969, 2971, 2999, 3001, 3011, 3019,
+    3023, 3037, 3041, 3049, 3061, 3067, 3079, 3083, 3089, 3109, 3119, 3121, 3137, 3163, 3167, 3169,
+    3181, 3187, 3191, 3203, 3209, 3217, 3221, 3229, 3251, 3253, 3257, 3259, 3271, 3299, 3301, 3307,
+    3313, 3319, 3323, 3329, 3331, 3343, 3347, 3359, 3361, 3371, 3373, 3389, 3391, 3407, 3413, 3433,
+    3449, 3457, 3461, 3463, 3467, 3469, 3491, 3499, 3511, 3517, 3527, 3529, 3533, 3539, 3541, 3547,
+    3557, 3559, 3571, 3581, 3583, 3593, 3607, 3613, 3617, 3623, 3631, 3637, 3643, 3659, 3671, 3673
+};
+
+/**
+ * One round of the Miller-Rabin test c.f. HAC Alg. 4.24 with the
+ * exponentiation and the squarings done on a shared Montgomery context
+ */
+static int miller_rabin_ctx(mont_ctx_t * ctx, uint16_t * d, int s, uint16_t * base) {
+    uint16_t y[MAX_WORDLENGTH];
+    uint16_t minus_one[MAX_WORDLENGTH];
+    int t = ctx->wordlength;
+    int j;
+
+    //1. y = base^d, kept in Montgomery form to square it further
+    mont_to(ctx, y, base);
+    mont_exp_mont_form(ctx, y, y, d, t);
+    subtract_mp_elements(minus_one, ctx->p, ctx->one, t);
+    if ((1 == are_mp_equal(y, ctx->one, t)) || (1 == are_mp_equal(y, minus_one, t))) {
+        return 1;
+    }
+    //2. Look for -1 among y^{2^j}
+    for (j = 1; j < s; j++) {
+        mont_multiply(ctx, y, y, y);
+        if (1 == are_mp_equal(y, minus_one, t)) {
+            return 1;
+        }
+        if (1 == are_mp_equal(y, ctx->one, t)) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+/*
+ * n - 1 = d*2^s with d odd, returns s
+ */
+static int split_n_minus_one(uint16_t * d, uint16_t * n, uint8_t wordlength) {
+    int s = 1;
+    int i;
+
+    copy_mp(d, n, wordlength);
+    d[0] &= 0xFFFE;
+    while (0 == mp_ith_bit(d, s)) {
+        s++;
+    }
+    for (i = 0; i < wordlength; i++) {
+        d[i] = mp_bits(d, wordlength, 16 * i + s, 16);
+    }
+    return s;
+}
+
+/**
+ * One round of the Miller-Rabin test c.f. HAC Alg. 4.24
+ * Input: n odd, n > 3, wordlength <= MAX_WORDLENGTH, base \in [2,n-2]
+ * Returns 0 if base proves n composite 1 otherwise
+ */
+int miller_rabin(uint16_t * n, uint8_t wordlength, uint16_t * base) {
+    mont_ctx_t ctx;
+    uint16_t d[MAX_WORDLENGTH];
+    int s;
+
+    wordlength = (uint8_t) (mp_non_zero_words(n, wordlength) + 1);
+    if (0 == mont_setup(&ctx, n, wordlength)) {
+        return 0;
+    }
+    s = split_n_minus_one(d, n, wordlength);
+    return miller_rabin_ctx(&ctx, d, s, base);
+}
+
+/*
+ * Miller-Rabin rounds on an n that survived trial division
+ */
+static int miller_rabin_rounds(uint16_t * n, uint8_t wordlength, int rounds, prime_rng_t rng, void * rng_arg) {
+    mont_ctx_t ctx;
+    uint16_t d[MAX_WORDLENGTH];
+    uint16_t base[MAX_WORDLENGTH];
+    int s, i;
+
+    if (0 == mont_setup(&ctx, n, wordlength)) {
+        return 0;
+    }
+    s = split_n_minus_one(d, n, wordlength);
+    for (i = 0; i < rounds; i++) {
+        //Base 2 first, it is the cheapest rejection, then random bases mod n
+        set_to_zero(base, wordlength);
+        if (0 == i) {
+            base[0] = 2;
+        } else if (NULL == rng) {
+            base[0] = small_primes[(i - 1) % M_PRIME_TRIAL_PRIMES];
+        } else {
+            rng(rng_arg, base, wordlength);
+            mont_mod(&ctx, base, base, wordlength);
+            if ((mp_non_zero_words(base, wordlength) <= 0) && (base[0] < 2)) {
+                base[0] = 2;
+            }
+        }
+        if (0 == miller_rabin_ctx(&ctx, d, s, base)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Trial division by the small primes followed by rounds of Miller-Rabin
+ * with random bases. The first round uses base 2.
+ * Returns 1 if n is a probable prime 0 if it is composite
+ */
+int is_probable_prime(uint16_t * n, uint8_t wordlength, int rounds, prime_rng_t rng, void * rng_arg) {
+    uint32_t low;
+    int top = mp_non_zero_words(n, wordlength);
+    int i;
+
+    if (top < 0) {
+        return 0;
+    }
+    wordlength = (uint8_t) (top + 1);
+    low = n[0];
+    if (top > 0) {
+        low |= ((uint32_t) n[1]) << 16;
+    }
+    if (0 == (n[0] & 1)) {
+        return (0 == top) && (2 == n[0]);
+    }
+    if ((0 == top) && (n[0] < 3)) {
+        return 0;
+    }
+
+    //1. Trial division with single word remainders
+    for (i = 0; i < M_PRIME_TRIAL_PRIMES; i++) {
+        if (0 == mp_mod_sp(n, wordlength, small_primes[i])) {
+            return (0 == top) && (n[0] == small_primes[i]);
+        }
+    }
+    //2. No factor up to the last small prime settles anything below its square
+    if ((top <= 1) && (low / small_primes[M_PRIME_TRIAL_PRIMES - 1] < small_primes[M_PRIME_TRIAL_PRIMES - 1])) {
+        return 1;
+    }
+    //3. Miller-Rabin
+    return miller_rabin_rounds(n, wordlength, (rounds < 1) ? 1 : rounds, rng, rng_arg);
+}
+
+/**
+ * Generates a random probable prime of exactly bits bits with the two top
+ * bits set, sieving M_PRIME_SIEVE_WINDOW candidates at a time
+ */
+int prime_generate(uint16_t * p, uint8_t wordlength, int bits, int rounds, prime_rng_t rng, void * rng_arg) {
+    uint16_t residues[M_PRIME_TRIAL_PRIMES];
+    uint16_t sieve[M_PRIME_SIEVE_WINDOW / 16];
+    uint16_t base[MAX_WORDLENGTH];
+    uint16_t step[MAX_WORDLENGTH];
+    uint16_t prime;
+    uint32_t k;
+    int i, top;
+
+    if ((wordlength > MAX_WORDLENGTH) || (bits < 16) || (bits > 16 * wordlength) || (NULL == rng)) {
+        return 0;
+    }
+    top = (bits - 1) / 16;
+
+    for (;;) {
+        //1. Random odd base with bits bits and the two top bits set
+        rng(rng_arg, base, wordlength);
+        for (i = top + 1; i < wordlength; i++) {
+            base[i] = 0;
+        }
+        base[top] &= (uint16_t) (0xFFFF >> (16 * (top + 1) - bits));
+        base[(bits - 1) / 16] |= (uint16_t) (1 << ((bits - 1) % 16));
+        base[(bits - 2) / 16] |= (uint16_t) (1 << ((bits - 2) % 16));
+        base[0] |= 1;
+        for (i = 0; i < M_PRIME_TRIAL_PRIMES; i++) {
+            residues[i] = mp_mod_sp(base, wordlength, small_primes[i]);
+        }
+
+        //2. Window after window of candidates base + 2k, until base outgrows bits
+        while (1 == mp_ith_bit(base, bits - 1)) {
+            //2.1 Cross out k with base + 2k = 0 mod prime, i.e. k = -residue/2
+            set_to_zero(sieve, M_PRIME_SIEVE_WINDOW / 16);
+            for (i = 0; i < M_PRIME_TRIAL_PRIMES; i++) {
+                prime = small_primes[i];
+                k = (((uint32_t) (prime - residues[i])) * ((uint32_t) ((prime + 1) / 2))) % prime;
+                for (; k < M_PRIME_SIEVE_WINDOW; k += prime) {
+                    sieve[k / 16] |= (uint16_t) (1 << (k % 16));
+                }
+            }
+            //2.2 Only the survivors get an exponentiation
+            for (k = 0; k < M_PRIME_SIEVE_WINDOW; k++) {
+                if (0 != (sieve[k / 16] & (1 << (k % 16)))) {
+                    continue;
+                }
+                set_to_zero(step, wordlength);
+                step[0] = (uint16_t) (2 * k);
+                add_mp_elements(p, base, step, wordlength);
+                if (0 == mp_ith_bit(p, bits - 1)) {
+                    break;
+                }
+                if (1 == miller_rabin_rounds(p, (uint8_t) (top + 1), (rounds < 1) ? 1 : rounds, rng, rng_arg)) {
+                    return 1;
+                }
+            }
+            //2.3 Move the base and its residues to the next window
+            set_to_zero(step, wordlength);
+            step[0] = (uint16_t) (2 * M_PRIME_SIEVE_WINDOW);
+            add_mp_elements(base, base, step, wordlength);
+            for (i = 0; i < M_PRIME_TRIAL_PRIMES; i++) {
+                residues[i] = (uint16_t) ((residues[i] + (uint32_t) ((2 * M_PRIME_SIEVE_WINDOW) % small_primes[i])) % small_primes[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * File:   m_prime.h
+ *
+ * Probabilistic primality testing and prime generation.
+ */
+
+#ifndef M_PRIME_H
+#define	M_PRIME_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+// Number of odd primes (3, 5, ..., at most 3673) used for trial division and
+// sieving. The table always has 512 entries, fewer saves stack on small parts.
+#ifndef M_PRIME_TRIAL_PRIMES
+#define M_PRIME_TRIAL_PRIMES 512
+#endif
+
+// Candidates sieved at once by prime_generate, a multiple of 16
+#define M_PRIME_SIEVE_WINDOW 1024
+
+/**
+ * Source of random words, fills out with wordlength uniformly random words
+ */
+typedef void (*prime_rng_t)(void * arg, uint16_t * out, uint8_t wordlength);
+
+/**
+ * One round of the Miller-Rabin test c.f. HAC Alg. 4.24
+ * Input: n odd, n > 3, wordlength <= MAX_WORDLENGTH, base \in [2,n-2]
+ * Returns 0 if base proves n composite 1 otherwise
+ */
+int miller_rabin(uint16_t * n, uint8_t wordlength, uint16_t * base);
+
+/**
+ * Trial division by the small primes followed by rounds of Miller-Rabin
+ * with random bases. The first round uses base 2.
+ * Returns 1 if n is a probable prime 0 if it is composite
+ */
+int is_probable_prime(uint16_t * n, uint8_t wordlength, int rounds, prime_rng_t rng, void * rng_arg);
+
+/**
+ * Generates a random probable prime of exactly bits bits with the two top
+ * bits set, so that the product of two such primes has 2*bits bits.
+ * Candidates are sieved M_PRIME_SIEVE_WINDOW at a time from residues modulo
+ * the small primes that are updated, not recomputed, between windows.
+ *
+ * @param p the prime, wordlength words
+ * @param bits between 16 and 16*wordlength
+ * @return 1 on success 0 on bad parameters
+ */
+int prime_generate(uint16_t * p, uint8_t wordlength, int bits, int rounds, prime_rng_t rng, void * rng_arg);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_PRIME_H */
+
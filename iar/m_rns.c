@@ -0,0 +1,373 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_rns.h"
+
+// 2^{-20} in the 32-bit fixed point of the base extension, above the worst
+// case error of the sum of k < 2^{9} truncated terms
+#define RNS_EXT_DELTA ((uint64_t) 1 << 12)
+
+/**
+ * Inverse of a modulo the prime m by the extended Euclidean algorithm,
+ * a \in [1,m-1]
+ */
+static uint16_t inverse_sp(uint16_t a, uint16_t m) {
+    int32_t r0 = m, r1 = a, s0 = 0, s1 = 1, q, t;
+
+    while (0 != r1) {
+        q = r0 / r1;
+        t = r0 - q * r1;
+        r0 = r1;
+        r1 = t;
+        t = s0 - q * s1;
+        s0 = s1;
+        s1 = t;
+    }
+    return (uint16_t) ((s0 < 0) ? s0 + m : s0);
+}
+
+static uint16_t mul_sp(uint16_t a, uint16_t b, uint16_t m) {
+    return (uint16_t) ((((uint32_t) a) * b) % m);
+}
+
+/**
+ * x mod m for x < 2^{32} by Barrett reduction c.f. HAC Alg. 14.42, with
+ * mu = floor(2^{32}/m) and m > 2^{15}. The quotient estimate is low by at
+ * most one, so there is a single conditional subtraction and no division.
+ */
+static uint16_t reduce_sp(uint32_t x, uint16_t m, uint32_t mu) {
+    uint32_t r = x - ((uint32_t) ((((uint64_t) x) * mu) >> 32)) * m;
+
+    return (uint16_t) ((r >= m) ? r - m : r);
+}
+
+static uint16_t mul_lane(uint16_t a, uint16_t b, uint16_t m, uint32_t mu) {
+    return reduce_sp(((uint32_t) a) * b, m, mu);
+}
+
+static int is_prime_sp(uint16_t p) {
+    uint16_t d;
+
+    for (d = 3; (uint32_t) d * d <= p; d += 2) {
+        if (0 == (p % d)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * floor(sum xi_l/m_l) over count lanes, in 32-bit fixed point from the
+ * truncated reciprocals. The result is at most the true sum and below it
+ * by less than count*2^{-31}.
+ */
+static uint64_t fraction_sum(uint16_t * xi, uint64_t * recip, int count) {
+    uint64_t sum = 0;
+    int l;
+
+    for (l = 0; l < count; l++) {
+        sum += (((uint64_t) xi[l]) * recip[l]) >> 16;
+    }
+    return sum;
+}
+
+/**
+ * Base extension c.f. Kawamura et al., from the xi of count source lanes to
+ * count destination lanes with moduli md, Barrett constants mu and c32:
+ * out_j = sum xi_l*ext[l][j] - alpha*mod_j mod md_j
+ */
+static void base_extend(uint16_t * out, uint16_t * xi, uint16_t ext[][RNS_MAX_BASE],
+        uint16_t * mod, uint16_t * md, uint32_t * mu, uint16_t * c32, uint32_t alpha, int count) {
+    uint64_t acc[RNS_MAX_BASE];
+    uint32_t t;
+    int j, l;
+
+    //1. One row of ext at a time, the rows are contiguous over the destination
+    //   lanes so the inner loop is a vector multiply-accumulate
+    for (j = 0; j < count; j++) {
+        acc[j] = 0;
+    }
+    for (l = 0; l < count; l++) {
+        for (j = 0; j < count; j++) {
+            acc[j] += ((uint32_t) xi[l]) * ext[l][j];
+        }
+    }
+
+    //2. acc = H*2^{32} + L with H < count, H*(2^{32} mod md_j) + (L mod md_j)
+    //   is below 2^{32} and alpha*mod_j is below 2^{25}
+    for (j = 0; j < count; j++) {
+        t = ((uint32_t) (acc[j] >> 32)) * c32[j] + reduce_sp((uint32_t) acc[j], md[j], mu[j]);
+        t = ((uint32_t) reduce_sp(t, md[j], mu[j])) + md[j] - reduce_sp(alpha * mod[j], md[j], mu[j]);
+        out[j] = (uint16_t) ((t >= md[j]) ? t - md[j] : t);
+    }
+}
+
+/**
+ * Picks the bases for N and fills ctx
+ */
+int rns_setup(rns_ctx_t * ctx, uint16_t * n, uint8_t wordlength) {
+    uint16_t M[2 * MAX_WORDLENGTH];
+    uint16_t t[2 * MAX_WORDLENGTH];
+    uint16_t m_mod_n[MAX_WORDLENGTH];
+    uint16_t prod_b, prod_bp;
+    uint16_t * mp = ctx->m + RNS_MAX_BASE;
+    uint16_t p;
+    int bits, k, i, j, l, words;
+
+    if ((wordlength > MAX_WORDLENGTH) || (mp_non_zero_words(n, wordlength) < 0)
+            || (0 == (n[0] & 1)) || ((1 == n[0]) && (0 == mp_non_zero_words(n, wordlength)))) {
+        return 0;
+    }
+    //1. k primes above 2^{15} per base give M, M' > 2^{15k} >= 64N
+    bits = mp_bit_length(n, wordlength) + 1;
+    k = (bits + 6 + 14) / 15;
+    if (k > RNS_MAX_BASE) {
+        return 0;
+    }
+    ctx->k = (uint16_t) k;
+    ctx->wordlength = wordlength;
+    copy_mp(ctx->n, n, wordlength);
+
+    //2. The 2k largest 16-bit primes not dividing N, B' at offset RNS_MAX_BASE
+    p = 65535;
+    for (i = 0; i < 2 * k; p -= 2) {
+        if ((1 == is_prime_sp(p)) && (0 != mp_mod_sp(n, wordlength, p))) {
+            if (i < k) {
+                ctx->m[i] = p;
+            } else {
+                mp[i - k] = p;
+            }
+            i++;
+        }
+    }
+
+    //3. Constants of the first base extension, B to B'
+    for (i = 0; i < k; i++) {
+        prod_b = 1;
+        for (l = 0; l < k; l++) {
+            if (l != i) {
+                prod_b = mul_sp(prod_b, ctx->m[l] % ctx->m[i], ctx->m[i]);
+            }
+        }
+        ctx->xi_q[i] = mul_sp(ctx->m[i] - inverse_sp(mp_mod_sp(n, wordlength, ctx->m[i]), ctx->m[i]),
+                inverse_sp(prod_b, ctx->m[i]), ctx->m[i]);
+        ctx->recip[i] = (((uint64_t) 1) << 48) / ctx->m[i];
+        ctx->mu[i] = (uint32_t) ((((uint64_t) 1) << 32) / ctx->m[i]);
+        ctx->c32[i] = (uint16_t) ((((uint64_t) 1) << 32) % ctx->m[i]);
+    }
+    for (j = 0; j < k; j++) {
+        prod_bp = 1;
+        for (l = 0; l < k; l++) {
+            prod_bp = mul_sp(prod_bp, ctx->m[l] % mp[j], mp[j]);
+        }
+        ctx->m_mod[j] = prod_bp;
+        ctx->m_inv[j] = inverse_sp(prod_bp, mp[j]);
+        ctx->n_mod[j] = mp_mod_sp(n, wordlength, mp[j]);
+        for (i = 0; i < k; i++) {
+            ctx->ext1[i][j] = mul_sp(prod_bp, inverse_sp(ctx->m[i] % mp[j], mp[j]), mp[j]);
+        }
+    }
+
+    //4. Constants of the second base extension, B' to B
+    for (j = 0; j < k; j++) {
+        prod_bp = 1;
+        for (l = 0; l < k; l++) {
+            if (l != j) {
+                prod_bp = mul_sp(prod_bp, mp[l] % mp[j], mp[j]);
+            }
+        }
+        ctx->xi_r[j] = inverse_sp(prod_bp, mp[j]);
+        ctx->recip[RNS_MAX_BASE + j] = (((uint64_t) 1) << 48) / mp[j];
+        ctx->mu[RNS_MAX_BASE + j] = (uint32_t) ((((uint64_t) 1) << 32) / mp[j]);
+        ctx->c32[RNS_MAX_BASE + j] = (uint16_t) ((((uint64_t) 1) << 32) % mp[j]);
+    }
+    for (i = 0; i < k; i++) {
+        prod_b = 1;
+        for (l = 0; l < k; l++) {
+            prod_b = mul_sp(prod_b, mp[l] % ctx->m[i], ctx->m[i]);
+        }
+        ctx->mp_mod[i] = prod_b;
+        for (j = 0; j < k; j++) {
+            ctx->ext2[j][i] = mul_sp(prod_b, inverse_sp(mp[j] % ctx->m[i], ctx->m[i]), ctx->m[i]);
+        }
+    }
+
+    //5. The inverses of the mixed radix conversion in B
+    for (i = 1; i < k; i++) {
+        for (j = 0; j < i; j++) {
+            ctx->mr_inv[i][j] = inverse_sp(ctx->m[j] % ctx->m[i], ctx->m[i]);
+        }
+    }
+
+    //6. M^2 mod N from M = m_1*...*m_k of at most k words
+    words = 1;
+    M[0] = 1;
+    for (i = 0; i < k; i++) {
+        multiply_sp_by_mp_element(t, ctx->m[i], M, words);
+        copy_mp(M, t, words + 1);
+        if (0 != M[words]) {
+            words++;
+        }
+    }
+    divide_mp_elements(NULL, m_mod_n, M, (uint16_t) words, n, wordlength);
+    multiply_mod_p(m_mod_n, m_mod_n, m_mod_n, n, wordlength);
+    for (i = 0; i < k; i++) {
+        ctx->r2[i] = mp_mod_sp(m_mod_n, wordlength, ctx->m[i]);
+        ctx->r2[RNS_MAX_BASE + i] = mp_mod_sp(m_mod_n, wordlength, mp[i]);
+    }
+    return 1;
+}
+
+/**
+ * RNS Montgomery multiplication
+ */
+void rns_multiply(rns_ctx_t * ctx, uint16_t * Z, uint16_t * X, uint16_t * Y) {
+    uint16_t s[2 * RNS_MAX_BASE];
+    uint16_t xi[RNS_MAX_BASE];
+    uint16_t q[RNS_MAX_BASE];
+    uint16_t * m = ctx->m;
+    uint16_t * mp = ctx->m + RNS_MAX_BASE;
+    uint16_t * sp = s + RNS_MAX_BASE;
+    uint32_t * mu = ctx->mu;
+    uint32_t * mu_p = ctx->mu + RNS_MAX_BASE;
+    uint32_t alpha;
+    int k = ctx->k;
+    int i, j;
+
+    //1. s = X*Y in every lane, the lanes of each base are independent and
+    //   reduced without division so every loop below vectorises
+    for (i = 0; i < k; i++) {
+        s[i] = mul_lane(X[i], Y[i], m[i], mu[i]);
+    }
+    for (j = 0; j < k; j++) {
+        sp[j] = mul_lane(X[RNS_MAX_BASE + j], Y[RNS_MAX_BASE + j], mp[j], mu_p[j]);
+    }
+
+    //2. q = -s*N^{-1} in B, extended to B' as q or q + M (alpha rounded down)
+    for (i = 0; i < k; i++) {
+        xi[i] = mul_lane(s[i], ctx->xi_q[i], m[i], mu[i]);
+    }
+    alpha = (uint32_t) (fraction_sum(xi, ctx->recip, k) >> 32);
+    base_extend(q, xi, ctx->ext1, ctx->m_mod, mp, mu_p, ctx->c32 + RNS_MAX_BASE, alpha, k);
+
+    //3. r = (s + q*N)/M in B', below 3N. sp + q*(N mod m') is below 2^{32}
+    for (j = 0; j < k; j++) {
+        q[j] = mul_lane(reduce_sp(sp[j] + ((uint32_t) q[j]) * ctx->n_mod[j], mp[j], mu_p[j]), ctx->m_inv[j], mp[j], mu_p[j]);
+    }
+
+    //4. Exact extension of r back to B, r < M'/2
+    for (j = 0; j < k; j++) {
+        xi[j] = mul_lane(q[j], ctx->xi_r[j], mp[j], mu_p[j]);
+    }
+    alpha = (uint32_t) ((fraction_sum(xi, ctx->recip + RNS_MAX_BASE, k) + RNS_EXT_DELTA) >> 32);
+    base_extend(Z, xi, ctx->ext2, ctx->mp_mod, m, mu, ctx->c32, alpha, k);
+    for (j = 0; j < k; j++) {
+        Z[RNS_MAX_BASE + j] = q[j];
+    }
+}
+
+/**
+ * Addition without reduction
+ */
+void rns_add(rns_ctx_t * ctx, uint16_t * Z, uint16_t * X, uint16_t * Y) {
+    uint32_t t;
+    int i;
+
+    for (i = 0; i < ctx->k; i++) {
+        t = ((uint32_t) X[i]) + Y[i];
+        Z[i] = (uint16_t) ((t >= ctx->m[i]) ? t - ctx->m[i] : t);
+        t = ((uint32_t) X[RNS_MAX_BASE + i]) + Y[RNS_MAX_BASE + i];
+        Z[RNS_MAX_BASE + i] = (uint16_t) ((t >= ctx->m[RNS_MAX_BASE + i]) ? t - ctx->m[RNS_MAX_BASE + i] : t);
+    }
+}
+
+/**
+ * Conversion into Montgomery form, residues of x then times M^2*M^{-1}
+ */
+void rns_from_mp(rns_ctx_t * ctx, uint16_t * X, uint16_t * x) {
+    uint16_t r[2 * RNS_MAX_BASE]; // X may be x
+    int i;
+
+    for (i = 0; i < ctx->k; i++) {
+        r[i] = mp_mod_sp(x, ctx->wordlength, ctx->m[i]);
+        r[RNS_MAX_BASE + i] = mp_mod_sp(x, ctx->wordlength, ctx->m[RNS_MAX_BASE + i]);
+    }
+    rns_multiply(ctx, X, r, ctx->r2);
+}
+
+/**
+ * Conversion out of Montgomery form, r = X*1*M^{-1} below 3N, then its
+ * mixed radix digits in B and Horner's rule
+ */
+void rns_to_mp(rns_ctx_t * ctx, uint16_t * x, uint16_t * X) {
+    uint16_t one[2 * RNS_MAX_BASE];
+    uint16_t r[2 * RNS_MAX_BASE];
+    uint16_t v[MAX_WORDLENGTH + 2];
+    uint16_t t[MAX_WORDLENGTH + 2];
+    uint16_t * m = ctx->m;
+    uint32_t d;
+    int words = ctx->wordlength + 1;
+    int k = ctx->k;
+    int i, j;
+
+    //1. Out of Montgomery form
+    for (i = 0; i < 2 * RNS_MAX_BASE; i++) {
+        one[i] = 1;
+    }
+    rns_multiply(ctx, r, X, one);
+
+    //2. Mixed radix digits, r = d_0 + m_0*(d_1 + m_1*(d_2 + ...)). Every
+    //   r_j < 2^{16} < 2*m_i, so one subtraction reduces it modulo m_i
+    for (i = 1; i < k; i++) {
+        for (j = 0; j < i; j++) {
+            d = r[j];
+            d = (d >= m[i]) ? d - m[i] : d;
+            d = ((uint32_t) r[i]) + m[i] - d;
+            d = (d >= m[i]) ? d - m[i] : d;
+            r[i] = mul_lane((uint16_t) d, ctx->mr_inv[i][j], m[i], ctx->mu[i]);
+        }
+    }
+
+    //3. Horner's rule, every partial value is at most r < 3N
+    set_to_zero(v, words + 1);
+    v[0] = r[k - 1];
+    for (i = k - 2; i >= 0; i--) {
+        multiply_sp_by_mp_element(t, m[i], v, words);
+        set_to_zero(v, words + 1);
+        v[0] = r[i];
+        add_mp_elements(v, v, t, words + 1);
+    }
+
+    //4. r mod N
+    copy_mp(t, ctx->n, ctx->wordlength);
+    set_to_zero(t + ctx->wordlength, words + 1 - ctx->wordlength);
+    while (1 == compare_mp_elements(v, t, words + 1)) {
+        subtract_mp_elements(v, v, t, words + 1);
+    }
+    copy_mp(x, v, ctx->wordlength);
+}
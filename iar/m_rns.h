@@ -0,0 +1,90 @@
+/*
+ * File:   m_rns.h
+ *
+ * Residue number system (RNS) arithmetic modulo an odd N. A value is held as
+ * its residues modulo two bases B = {m_1, ..., m_k} and B' = {m'_1, ..., m'_k}
+ * of distinct 16-bit primes, so that a multiplication is 2k independent
+ * single word products with no carries between lanes. Reduction modulo N is
+ * RNS Montgomery multiplication c.f. Bajard, Didier and Kornerup, "An RNS
+ * Montgomery Modular Multiplication Algorithm", with the base extensions of
+ * Kawamura et al., "Cox-Rower Architecture for Fast Parallel Montgomery
+ * Multiplication".
+ */
+
+#ifndef M_RNS_H
+#define	M_RNS_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+#include "m_defs.h"
+
+// Primes per base for a modulus of MAX_WORDLENGTH words. M and M' must exceed
+// 64N and every prime is above 2^{15}.
+#define RNS_MAX_BASE ((16 * MAX_WORDLENGTH + 6 + 14) / 15)
+
+/**
+ * Precomputed values for a modulus N with M = m_1*...*m_k, M' = m'_1*...*m'_k.
+ * A value X of the context is an array of 2k residues, B first, and stands
+ * for an integer below 6N. Large, allocate it statically or on the heap.
+ */
+typedef struct {
+    uint16_t m[2 * RNS_MAX_BASE];                // B then B'
+    uint64_t recip[2 * RNS_MAX_BASE];            // floor(2^48 / m)
+    uint32_t mu[2 * RNS_MAX_BASE];               // floor(2^32 / m), for Barrett reduction
+    uint16_t c32[2 * RNS_MAX_BASE];              // 2^32 mod m
+    uint16_t xi_q[RNS_MAX_BASE];                 // -N^{-1}*(M/m_i)^{-1} mod m_i
+    uint16_t ext1[RNS_MAX_BASE][RNS_MAX_BASE];   // (M/m_i) mod m'_j
+    uint16_t m_mod[RNS_MAX_BASE];                // M mod m'_j
+    uint16_t n_mod[RNS_MAX_BASE];                // N mod m'_j
+    uint16_t m_inv[RNS_MAX_BASE];                // M^{-1} mod m'_j
+    uint16_t xi_r[RNS_MAX_BASE];                 // (M'/m'_j)^{-1} mod m'_j
+    uint16_t ext2[RNS_MAX_BASE][RNS_MAX_BASE];   // (M'/m'_j) mod m_i
+    uint16_t mp_mod[RNS_MAX_BASE];               // M' mod m_i
+    uint16_t mr_inv[RNS_MAX_BASE][RNS_MAX_BASE]; // m_j^{-1} mod m_i for j < i, mixed radix
+    uint16_t r2[2 * RNS_MAX_BASE];               // M^2 mod N
+    uint16_t n[MAX_WORDLENGTH];
+    uint16_t k;
+    uint8_t wordlength;
+} rns_ctx_t;
+
+/**
+ * Picks the bases for N and fills ctx
+ * Input: n odd, n > 1, wordlength <= MAX_WORDLENGTH
+ * Returns 1 on success 0 if n is not a valid modulus
+ */
+int rns_setup(rns_ctx_t * ctx, uint16_t * n, uint8_t wordlength);
+
+/**
+ * Conversion from the limb format into Montgomery form, X = x*M mod N
+ * Input: x \in [0,N-1] of ctx->wordlength words, X may be x
+ */
+void rns_from_mp(rns_ctx_t * ctx, uint16_t * X, uint16_t * x);
+
+/**
+ * Conversion out of Montgomery form to the limb format, x = X*M^{-1} mod N
+ * in [0,N-1], by mixed radix conversion c.f. HAC Alg. 14.71
+ */
+void rns_to_mp(rns_ctx_t * ctx, uint16_t * x, uint16_t * X);
+
+/**
+ * RNS Montgomery multiplication, Z = X*Y*M^{-1} mod N
+ * Input: X, Y below 6N
+ * Output: Z below 3N, Z may be X or Y
+ */
+void rns_multiply(rns_ctx_t * ctx, uint16_t * Z, uint16_t * X, uint16_t * Y);
+
+/**
+ * Addition without reduction, Z = X + Y. The sum of two products of
+ * rns_multiply is below 6N and may be multiplied again.
+ */
+void rns_add(rns_ctx_t * ctx, uint16_t * Z, uint16_t * X, uint16_t * Y);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_RNS_H */
+
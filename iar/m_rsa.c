@@ -0,0 +1,130 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_mont.h"
+#include "m_rsa.h"
+
+#ifdef M_USE_PTHREADS
+#include <pthread.h>
+#endif
+
+/*
+ * One half of the CRT computation, out = (c mod p)^d mod p
+ */
+typedef struct {
+    mont_ctx_t ctx;
+    uint16_t out[MAX_WORDLENGTH];
+    uint16_t * c;
+    uint16_t * d;
+    uint16_t c_wordlength;
+} rsa_half_t;
+
+static void * rsa_half_exp(void * arg) {
+    rsa_half_t * half = (rsa_half_t *) arg;
+
+    mont_mod(&half->ctx, half->out, half->c, half->c_wordlength);
+    mont_exp(&half->ctx, half->out, half->out, half->d, half->ctx.wordlength);
+    return NULL;
+}
+
+/*
+ * Checks m^e = c modulo the prime of half, i.e. modulo p and q together
+ * the check m^e = c mod n without full size arithmetic
+ */
+static int rsa_half_check(rsa_half_t * half, uint16_t * m, uint16_t * e, uint8_t e_wordlength) {
+    uint16_t m_p[MAX_WORDLENGTH];
+    uint16_t c_p[MAX_WORDLENGTH];
+
+    mont_mod(&half->ctx, m_p, m, half->c_wordlength);
+    mont_exp(&half->ctx, m_p, m_p, e, e_wordlength);
+    mont_mod(&half->ctx, c_p, half->c, half->c_wordlength);
+    return are_mp_equal(m_p, c_p, half->ctx.wordlength);
+}
+
+/**
+ * RSA decryption/signature with the CRT and Garner's recombination
+ * c.f. HAC Note 14.75
+ */
+int rsa_private_crt(uint16_t * m, uint16_t * c, rsa_crt_key_t * key) {
+    rsa_half_t half_p;
+    rsa_half_t half_q;
+    uint16_t h[MAX_WORDLENGTH];
+    uint16_t m2[MAX_WORDLENGTH];
+    uint16_t hq[2 * MAX_WORDLENGTH];
+    uint16_t t = key->half_wordlength;
+#ifdef M_USE_PTHREADS
+    pthread_t thread;
+    int threaded;
+#endif
+
+    if ((0 == mont_setup(&half_p.ctx, key->p, t)) || (0 == mont_setup(&half_q.ctx, key->q, t))
+            || (1 == compare_mp_elements(c, key->n, 2 * t))
+            || (1 == compare_mp_elements(key->qinv, key->p, t))) {
+        return M_RSA_ERR_PARAM;
+    }
+    half_p.c = c;
+    half_p.c_wordlength = 2 * t;
+    half_p.d = key->dp;
+    half_q.c = c;
+    half_q.c_wordlength = 2 * t;
+    half_q.d = key->dq;
+
+    //1. m1 = c^dp mod p and m2 = c^dq mod q, c < n < p*R so mont_mod applies
+#ifdef M_USE_PTHREADS
+    threaded = (0 == pthread_create(&thread, NULL, rsa_half_exp, &half_p));
+    rsa_half_exp(&half_q);
+    if (threaded) {
+        pthread_join(thread, NULL);
+    } else {
+        rsa_half_exp(&half_p);
+    }
+#else
+    rsa_half_exp(&half_p);
+    rsa_half_exp(&half_q);
+#endif
+
+    //2. h = qinv*(m1 - m2) mod p, m2 < q may exceed p
+    mont_mod(&half_p.ctx, m2, half_q.out, t);
+    subtract_mod_p(h, half_p.out, m2, key->p, t);
+    multiply_mod_p_mont(&half_p.ctx, h, h, key->qinv);
+
+    //3. m = m2 + h*q < n
+    multiply_mp_elements(hq, h, key->q, t);
+    set_to_zero(m2, t);
+    m2[0] = add_mp_elements(hq, hq, half_q.out, t);
+    add_mp_elements(&hq[t], &hq[t], m2, t);
+
+    //4. Verify before releasing anything, c is still intact if m is c
+    if ((0 == rsa_half_check(&half_p, hq, key->e, key->e_wordlength))
+            || (0 == rsa_half_check(&half_q, hq, key->e, key->e_wordlength))) {
+        set_to_zero(m, 2 * t);
+        return M_RSA_ERR_FAULT;
+    }
+    copy_mp(m, hq, 2 * t);
+    return M_RSA_OK;
+}
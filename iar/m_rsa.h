@@ -0,0 +1,56 @@
+/*
+ * File:   m_rsa.h
+ *
+ * RSA private key operation with the Chinese Remainder Theorem.
+ */
+
+#ifndef M_RSA_H
+#define	M_RSA_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+//Status codes
+#define M_RSA_OK                0
+#define M_RSA_ERR_PARAM         1
+#define M_RSA_ERR_FAULT         2
+
+/**
+ * RSA private key in CRT form. p, q, dp, dq and qinv have half_wordlength
+ * words, half_wordlength <= MAX_WORDLENGTH, and n = p*q has twice as many.
+ * e is only used to check the result.
+ */
+typedef struct {
+    uint16_t * p;
+    uint16_t * q;
+    uint16_t * dp;   // d mod (p-1)
+    uint16_t * dq;   // d mod (q-1)
+    uint16_t * qinv; // q^{-1} mod p
+    uint16_t * n;
+    uint16_t * e;
+    uint8_t half_wordlength;
+    uint8_t e_wordlength;
+} rsa_crt_key_t;
+
+/**
+ * RSA decryption/signature with the CRT and Garner's recombination
+ * c.f. HAC Note 14.75. With M_USE_PTHREADS the exponentiations modulo p and
+ * modulo q run on two threads. The result is checked by re-encrypting modulo
+ * p and modulo q, a faulty result is never released.
+ *
+ * @param m the result c^d mod n, 2*half_wordlength words, m may be c
+ * @param c an element of [0,n-1], 2*half_wordlength words
+ * @param key the private key
+ * @return M_RSA_OK, M_RSA_ERR_PARAM for a bad key or input, M_RSA_ERR_FAULT
+ *         if the check failed (m is then zero)
+ */
+int rsa_private_crt(uint16_t * m, uint16_t * c, rsa_crt_key_t * key);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_RSA_H */
+
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2010 UMass Amherst. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are
+ * permitted provided that the following conditions are met:
+ *
+ *    1. Redistributions of source code must retain the above copyright notice, this list of
+ *       conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *       of conditions and the following disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY UMass Amherst ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ * FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL <COPYRIGHT HOLDER> OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+
+#include "m_defs.h"
+#include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_table.h"
+
+static uint32_t get_u32(const uint16_t * t) {
+    return ((uint32_t) t[0]) | (((uint32_t) t[1]) << 16);
+}
+
+static void put_u32(uint16_t * t, uint32_t v) {
+    t[0] = (uint16_t) v;
+    t[1] = (uint16_t) (v >> 16);
+}
+
+/**
+ * Fletcher-32 checksum over n 16-bit words
+ */
+uint32_t table_fletcher32(const uint16_t * data, uint32_t n) {
+    uint32_t sum1 = 0xFFFF;
+    uint32_t sum2 = 0xFFFF;
+    uint32_t block;
+
+    while (n > 0) {
+        //359 words is the longest run that cannot overflow sum2
+        block = (n > 359) ? 359 : n;
+        n -= block;
+        while (block > 0) {
+            sum1 += *data++;
+            sum2 += sum1;
+            block--;
+        }
+        sum1 = (sum1 & 0xFFFF) + (sum1 >> 16);
+        sum2 = (sum2 & 0xFFFF) + (sum2 >> 16);
+    }
+    sum1 = (sum1 & 0xFFFF) + (sum1 >> 16);
+    sum2 = (sum2 & 0xFFFF) + (sum2 >> 16);
+    return (sum2 << 16) | sum1;
+}
+
+/**
+ * Size in words (header included) of a table with the given shape
+ */
+uint32_t table_size_words(uint16_t wordlength, uint16_t window, uint16_t windows) {
+    uint32_t entries;
+
+    if ((0 == window) || (window > M_TABLE_MAX_WINDOW)) {
+        return 0;
+    }
+    entries = ((((uint32_t) 1) << window) - 1) * ((uint32_t) windows);
+    return M_TABLE_HEADER_WORDS + entries * ((uint32_t) wordlength);
+}
+
+/**
+ * Returns a pointer into the table to entry g^(v * 2^(k*j)), 1 <= v < 2^k
+ */
+const uint16_t * table_entry(const uint16_t * t, uint16_t j, uint16_t v) {
+    uint32_t per_window = (((uint32_t) 1) << t[M_TABLE_W_WINDOW]) - 1;
+    uint32_t index = ((uint32_t) j) * per_window + ((uint32_t) v) - 1;
+
+    return t + t[M_TABLE_W_HEADER_WORDS] + index * ((uint32_t) t[M_TABLE_W_WORDLENGTH]);
+}
+
+/**
+ * Builds the fixed-base table for g modulo p_192 covering exponents of up to
+ * bits bits, with k = window bits per digit.
+ */
+int table_build_p_192(uint16_t * M_RESTRICT t, uint32_t size_words, uint16_t * g, uint16_t window, uint16_t bits) {
+    uint16_t windows;
+    uint16_t per_window;
+    uint16_t * base;
+    uint16_t * entry;
+    uint16_t j, v;
+    int i;
+
+    if ((0 == window) || (window > M_TABLE_MAX_WINDOW) || (0 == bits)) {
+        return M_TABLE_ERR_PARAM;
+    }
+    windows = (bits + window - 1) / window;
+    if (size_words != table_size_words(WORDLENGTH, window, windows)) {
+        return M_TABLE_ERR_SIZE;
+    }
+    per_window = (uint16_t) ((1 << window) - 1);
+
+    set_to_zero(t, M_TABLE_HEADER_WORDS);
+    t[M_TABLE_W_MAGIC] = M_TABLE_MAGIC0;
+    t[M_TABLE_W_MAGIC + 1] = M_TABLE_MAGIC1;
+    t[M_TABLE_W_VERSION] = M_TABLE_VERSION;
+    t[M_TABLE_W_HEADER_WORDS] = M_TABLE_HEADER_WORDS;
+    t[M_TABLE_W_MODULUS] = M_TABLE_MOD_P192;
+    t[M_TABLE_W_WORDLENGTH] = WORDLENGTH;
+    t[M_TABLE_W_WINDOW] = window;
+    t[M_TABLE_W_WINDOWS] = windows;
+    put_u32(&t[M_TABLE_W_PAYLOAD_WORDS], size_words - M_TABLE_HEADER_WORDS);
+
+    //1. The first entry of window j is g^(2^(k*j))
+    //2. The remaining entries of the window are successive multiples of it
+    for (j = 0; j < windows; j++) {
+        base = (uint16_t *) table_entry(t, j, 1);
+        if (0 == j) {
+            copy_mp(base, g, WORDLENGTH);
+        } else {
+            copy_mp(base, (uint16_t *) table_entry(t, j - 1, 1), WORDLENGTH);
+            for (i = 0; i < window; i++) {
+                multiply_mod_p_192(base, base, base);
+            }
+        }
+        for (v = 2; v <= per_window; v++) {
+            entry = (uint16_t *) table_entry(t, j, v);
+            multiply_mod_p_192(entry, entry - WORDLENGTH, base);
+        }
+    }
+
+    put_u32(&t[M_TABLE_W_PAYLOAD_SUM],
+            table_fletcher32(t + M_TABLE_HEADER_WORDS, size_words - M_TABLE_HEADER_WORDS));
+    put_u32(&t[M_TABLE_W_HEADER_SUM], table_fletcher32(t, M_TABLE_W_HEADER_SUM));
+    return M_TABLE_OK;
+}
+
+/**
+ * Validates a table image of size_words words: magic, byte order, version,
+ * shape and header checksum. The payload checksum is only verified if
+ * verify_payload is non zero, as it touches every page of the table.
+ */
+int table_check(const uint16_t * t, uint32_t size_words, int verify_payload) {
+    uint16_t header_words;
+
+    if (size_words < M_TABLE_HEADER_WORDS) {
+        return M_TABLE_ERR_SIZE;
+    }
+    if ((M_TABLE_MAGIC0 != t[M_TABLE_W_MAGIC]) || (M_TABLE_MAGIC1 != t[M_TABLE_W_MAGIC + 1])) {
+        //A big-endian reader sees every word byte swapped
+        if ((0x4D55 == t[M_TABLE_W_MAGIC]) && (0x4254 == t[M_TABLE_W_MAGIC + 1])) {
+            return M_TABLE_ERR_ENDIAN;
+        }
+        return M_TABLE_ERR_MAGIC;
+    }
+    if (M_TABLE_VERSION != t[M_TABLE_W_VERSION]) {
+        return M_TABLE_ERR_VERSION;
+    }
+    if (table_fletcher32(t, M_TABLE_W_HEADER_SUM) != get_u32(&t[M_TABLE_W_HEADER_SUM])) {
+        return M_TABLE_ERR_HEADER;
+    }
+    header_words = t[M_TABLE_W_HEADER_WORDS];
+    if ((M_TABLE_HEADER_WORDS != header_words) || (M_TABLE_MOD_P192 != t[M_TABLE_W_MODULUS])
+            || (WORDLENGTH != t[M_TABLE_W_WORDLENGTH])
+            || (0 == t[M_TABLE_W_WINDOWS])
+            || (0 == table_size_words(t[M_TABLE_W_WORDLENGTH], t[M_TABLE_W_WINDOW], t[M_TABLE_W_WINDOWS]))) {
+        return M_TABLE_ERR_PARAM;
+    }
+    if ((size_words != table_size_words(t[M_TABLE_W_WORDLENGTH], t[M_TABLE_W_WINDOW], t[M_TABLE_W_WINDOWS]))
+            || (size_words - header_words != get_u32(&t[M_TABLE_W_PAYLOAD_WORDS]))) {
+        return M_TABLE_ERR_SIZE;
+    }
+    if ((0 != verify_payload)
+            && (table_fletcher32(t + header_words, size_words - header_words) != get_u32(&t[M_TABLE_W_PAYLOAD_SUM]))) {
+        return M_TABLE_ERR_PAYLOAD;
+    }
+    return M_TABLE_OK;
+}
+
+/**
+ * Fixed-base exponentiation modulo p_192 with a validated table for g.
+ * One multiplication per non-zero k-bit digit of e and no squarings.
+ */
+int mod_exp_p_192_fb(uint16_t * A, const uint16_t * t, uint16_t * e, uint16_t e_length) {
+    uint16_t X[WORDLENGTH]; // A, which may be e
+    uint16_t window = t[M_TABLE_W_WINDOW];
+    uint16_t windows = t[M_TABLE_W_WINDOWS];
+    uint16_t digit;
+    uint16_t j;
+
+    //The exponent must not have set bits past the last window
+    if ((mp_non_zero_words(e, e_length) >= 0)
+            && (mp_bit_length(e, e_length) >= ((int) window) * ((int) windows))) {
+        return M_TABLE_ERR_RANGE;
+    }
+
+    //1.
+    set_to_zero(X, WORDLENGTH);
+    X[0] = 1;
+    //2. X = prod_j T[j][e_j]
+    for (j = 0; j < windows; j++) {
+        digit = mp_bits(e, e_length, j * window, window);
+        if (0 != digit) {
+            multiply_mod_p_192(X, X, (uint16_t *) table_entry(t, j, digit));
+        }
+    }
+    copy_mp(A, X, WORDLENGTH);
+    return M_TABLE_OK;
+}
+
+/**
+ * Copies the chunk bases g^{2^{i*m}}, 0 <= i < k, for mod_exp_p_192_split out
+ * of a table for g. m must be a multiple of the window width of the table.
+ */
+int table_split_bases_p_192(uint16_t * M_RESTRICT bases, const uint16_t * t, int k, int m) {
+    int window = t[M_TABLE_W_WINDOW];
+    int i;
+
+    if ((m < 1) || (0 != m % window)) {
+        return M_TABLE_ERR_PARAM;
+    }
+    if ((k - 1) * (m / window) >= t[M_TABLE_W_WINDOWS]) {
+        return M_TABLE_ERR_RANGE;
+    }
+    //Entry (j, 1) is g^{2^{window*j}}
+    for (i = 0; i < k; i++) {
+        copy_mp(&bases[WORDLENGTH * i], (uint16_t *) table_entry(t, (uint16_t) (i * (m / window)), 1), WORDLENGTH);
+    }
+    return M_TABLE_OK;
+}
@@ -0,0 +1,129 @@
+/*
+ * File:   m_table.h
+ *
+ * Precomputed fixed-base tables that can be used in place, from flash on the
+ * MSP430 or from a read-only memory mapped file on a host.
+ */
+
+#ifndef M_TABLE_H
+#define	M_TABLE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+#include "m_defs.h"
+
+/*
+ * A table is an array of 16-bit words stored little-endian, so the file image
+ * is the in-memory image on the MSP430 and on little-endian hosts. It starts
+ * with a fixed header of M_TABLE_HEADER_WORDS words:
+ *
+ *  word  0-1  magic, the bytes "MUBT"
+ *  word  2    format version
+ *  word  3    header length in words
+ *  word  4    modulus id (M_TABLE_MOD_P192)
+ *  word  5    wordlength of an entry
+ *  word  6    window width k in bits
+ *  word  7    number of windows d
+ *  word  8-9  payload length in words (low word first)
+ *  word 10-11 Fletcher-32 checksum of the payload
+ *  word 12-13 reserved, zero
+ *  word 14-15 Fletcher-32 checksum of words 0-13
+ *
+ * The payload holds d windows of 2^k - 1 entries each. Entry (j, v) is
+ * g^(v * 2^(k*j)) for 1 <= v < 2^k, so that g^e is the product of one entry
+ * per non-zero k-bit digit of e, c.f. HAC Alg. 14.109 with no squarings.
+ */
+#define M_TABLE_MAGIC0          0x554D
+#define M_TABLE_MAGIC1          0x5442
+#define M_TABLE_VERSION         1
+#define M_TABLE_HEADER_WORDS    16
+#define M_TABLE_MAX_WINDOW      8
+
+#define M_TABLE_MOD_P192        1
+
+#define M_TABLE_W_MAGIC         0
+#define M_TABLE_W_VERSION       2
+#define M_TABLE_W_HEADER_WORDS  3
+#define M_TABLE_W_MODULUS       4
+#define M_TABLE_W_WORDLENGTH    5
+#define M_TABLE_W_WINDOW        6
+#define M_TABLE_W_WINDOWS       7
+#define M_TABLE_W_PAYLOAD_WORDS 8
+#define M_TABLE_W_PAYLOAD_SUM   10
+#define M_TABLE_W_HEADER_SUM    14
+
+//Status codes
+#define M_TABLE_OK              0
+#define M_TABLE_ERR_SIZE        1
+#define M_TABLE_ERR_MAGIC       2
+#define M_TABLE_ERR_ENDIAN      3
+#define M_TABLE_ERR_VERSION     4
+#define M_TABLE_ERR_HEADER      5
+#define M_TABLE_ERR_PAYLOAD     6
+#define M_TABLE_ERR_PARAM       7
+#define M_TABLE_ERR_RANGE       8
+
+/**
+ * Fletcher-32 checksum over n 16-bit words
+ */
+uint32_t table_fletcher32(const uint16_t * data, uint32_t n);
+
+/**
+ * Size in words (header included) of a table with the given shape
+ */
+uint32_t table_size_words(uint16_t wordlength, uint16_t window, uint16_t windows);
+
+/**
+ * Builds the fixed-base table for g modulo p_192 covering exponents of up to
+ * bits bits, with k = window bits per digit.
+ *
+ * @param t output buffer of size_words words, not overlapping g
+ * @param size_words must equal table_size_words(12, window, ceil(bits/window))
+ * @param g an element of Z*_p
+ * @return M_TABLE_OK or an M_TABLE_ERR_ code
+ */
+int table_build_p_192(uint16_t * M_RESTRICT t, uint32_t size_words, uint16_t * g, uint16_t window, uint16_t bits);
+
+/**
+ * Validates a table image of size_words words: magic, byte order, version,
+ * shape and header checksum. The payload checksum is only verified if
+ * verify_payload is non zero, as it touches every page of the table.
+ *
+ * @return M_TABLE_OK or an M_TABLE_ERR_ code
+ */
+int table_check(const uint16_t * t, uint32_t size_words, int verify_payload);
+
+/**
+ * Returns a pointer into the table to entry g^(v * 2^(k*j)), 1 <= v < 2^k
+ */
+const uint16_t * table_entry(const uint16_t * t, uint16_t j, uint16_t v);
+
+/**
+ * Fixed-base exponentiation modulo p_192 with a validated table for g
+ *
+ * @param A The result of raising g to the power of e, A may be e
+ * @param t a table built by table_build_p_192
+ * @param e a multi-precission exponent
+ * @param e_length the wordlength of the multi-precission exponent
+ * @return M_TABLE_OK, or M_TABLE_ERR_RANGE if e has more bits than the table covers
+ */
+int mod_exp_p_192_fb(uint16_t * A, const uint16_t * t, uint16_t * e, uint16_t e_length);
+
+/**
+ * Copies the chunk bases g^{2^{i*m}}, 0 <= i < k, for mod_exp_p_192_split out
+ * of a table for g. m must be a multiple of the window width of the table.
+ *
+ * @return M_TABLE_OK, M_TABLE_ERR_PARAM if m is not a multiple of the window
+ *         or M_TABLE_ERR_RANGE if the table is too short
+ */
+int table_split_bases_p_192(uint16_t * M_RESTRICT bases, const uint16_t * t, int k, int m);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* M_TABLE_H */
+
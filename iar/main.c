@@ -1,9 +1,24 @@
 
+#include <stddef.h>
+#include <string.h>
+
 #include "io430.h"
 #include "m_defs.h"
 #include "m_arith.h"
+#include "m_arith_p192.h"
+#include "m_arith_mont.h"
+#include "m_arith_p192_split.h"
+#include "m_conv.h"
+#include "m_prime.h"
+#include "m_gcd.h"
+#include "m_fp2_p192.h"
+#include "m_ec_p192.h"
+#include "m_rsa.h"
+#include "m_table.h"
+#include "m_gf2m.h"
+#include "m_rns.h"
 
-void test_sum() {
+int test_sum() {
     int errors = 0;
     uint16_t a_0[12] = {0x7DA0, 0x6C9D, 0x574F, 0xD615, 0x85C2, 0xCB5F, 0xCA49, 0x4285, 0x1F5C, 0x7799, 0xEA25, 0xD94C};
     uint16_t b_0[12] = {0xF3EA, 0x85D3, 0x0C32, 0xA075, 0xC431, 0x4AA2, 0xBC82, 0x96C5, 0xF7A7, 0x2B89, 0x0215, 0xD845};
@@ -13,12 +28,740 @@ void test_sum() {
     if (0 == are_mp_equal(c_0, d_0, 12)) {
         errors++;
     }
+    return errors;
+}
+
+/*
+ * Fletcher-32 of "abcdef", and a table for g = x(G) of SEC P-192 with 4-bit
+ * windows covering 32-bit exponents
+ */
+int test_table() {
+    int errors = 0;
+    static uint16_t t[M_TABLE_HEADER_WORDS + 8 * 15 * 12];
+    uint16_t abcdef[3] = {0x6261, 0x6463, 0x6665};
+    uint16_t g[12] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    uint16_t e[3] = {0xBEEF, 0xDEAD, 0x0000};
+    uint16_t e_long[3] = {0xBEEF, 0xDEAD, 0x0001};
+    //g^0xDEADBEEF mod p_192
+    uint16_t c_0[12] = {0xA11D, 0xADD7, 0xAC0B, 0x4DD3, 0xED87, 0x0236, 0x411B, 0x3357, 0xA5CB, 0xE958, 0xEAFB, 0x5202};
+    uint16_t d_0[12];
+    uint32_t size = table_size_words(12, 4, 8);
+
+    if ((0x56502D2AUL != table_fletcher32(abcdef, 3)) || (sizeof(t) / sizeof(t[0]) != size)) {
+        errors++;
+    }
+    if ((M_TABLE_OK != table_build_p_192(t, size, g, 4, 32)) || (M_TABLE_OK != table_check(t, size, 1))) {
+        errors++;
+    }
+    if ((M_TABLE_OK != mod_exp_p_192_fb(d_0, t, e, 3)) || (0 == are_mp_equal(c_0, d_0, 12))) {
+        errors++;
+    }
+    mod_exp_p_192(d_0, g, e, 2);
+    if (0 == are_mp_equal(c_0, d_0, 12)) {
+        errors++;
+    }
+    //A on top of e
+    set_to_zero(d_0, 12);
+    copy_mp(d_0, e, 3);
+    if ((M_TABLE_OK != mod_exp_p_192_fb(d_0, t, d_0, 3)) || (0 == are_mp_equal(c_0, d_0, 12))) {
+        errors++;
+    }
+    if (M_TABLE_ERR_RANGE != mod_exp_p_192_fb(d_0, t, e_long, 3)) {
+        errors++;
+    }
+    //A flipped payload bit is only seen by the full check
+    t[size - 1] ^= 1;
+    if ((M_TABLE_OK != table_check(t, size, 0)) || (M_TABLE_ERR_PAYLOAD != table_check(t, size, 1))) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * Square roots modulo p_192 and the P-224 prime p = 1 mod 2^{96} (Tonelli-
+ * Shanks), and decompression of the SEC P-192 base point G
+ */
+int test_sqrt() {
+    int errors = 0;
+    mont_ctx_t ctx;
+    uint16_t p_224[14] = {0x0001, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    //The smaller square root of 2 modulo p_224
+    uint16_t r_0[14] = {0xE34C, 0x8A09, 0x2DCE, 0x51B1, 0x68AB, 0xE317, 0xA50D, 0x23D2, 0x2379, 0xD430, 0x1094, 0x1ABE, 0x4182, 0x6D7E};
+    uint16_t a_0[14] = {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t p_192[12] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    uint16_t four[12] = {4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t minus_one[12] = {0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    uint16_t x[36] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D,
+                      1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                      0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    //y(G) and p - y(G)
+    uint16_t y_0[12] = {0x4811, 0x1E79, 0x77A1, 0x73F9, 0xCDD5, 0x6B24, 0x11ED, 0x6310, 0xDA78, 0xFFC8, 0x2B95, 0x0719};
+    uint16_t y_1[12] = {0xB7EE, 0xE186, 0x885E, 0x8C06, 0x3229, 0x94DB, 0xEE12, 0x9CEF, 0x2587, 0x0037, 0xD46A, 0xF8E6};
+    uint8_t y_bits[3] = {1, 0, 0};
+    uint8_t valid[3];
+    uint16_t y[36];
+    uint16_t d_0[14];
+
+    //1. Tonelli-Shanks, either root
+    if ((0 == mont_setup(&ctx, p_224, 14)) || (0 == sqrt_mod_p_mont(&ctx, d_0, a_0))) {
+        errors++;
+    } else {
+        if (0 == are_mp_equal(d_0, r_0, 14)) {
+            subtract_mp_elements(d_0, p_224, d_0, 14);
+        }
+        if (0 == are_mp_equal(d_0, r_0, 14)) {
+            errors++;
+        }
+    }
+    //2. sqrt(4) = +-2 and -1 is a non-residue as p_192 = 3 mod 4
+    if (0 == sqrt_mod_p_192(d_0, four)) {
+        errors++;
+    } else {
+        if (2 != d_0[0]) {
+            subtract_mp_elements(d_0, p_192, d_0, 12);
+        }
+        if ((2 != d_0[0]) || (-1 != mp_non_zero_words(d_0 + 1, 11))) {
+            errors++;
+        }
+    }
+    if (0 != sqrt_mod_p_192(d_0, minus_one)) {
+        errors++;
+    }
+    //3. G with either parity of y, and x = 1 that is not on the curve
+    if ((1 != decompress_point_p_192(y, x, 1)) || (0 == are_mp_equal(y, y_0, 12))
+            || (1 != decompress_point_p_192(y, x, 0)) || (0 == are_mp_equal(y, y_1, 12))
+            || (0 != decompress_point_p_192(y, x + 12, 0))) {
+        errors++;
+    }
+    if ((2 != decompress_points_p_192(y, x, y_bits, valid, 3)) || (1 != valid[0]) || (0 != valid[1])
+            || (1 != valid[2]) || (0 == are_mp_equal(y, y_0, 12)) || (0 == are_mp_equal(y + 24, y_1, 12))) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * RSA-CRT with a 512-bit key (e = 65537), into a separate buffer, in place,
+ * and with a corrupted dp that the check must catch
+ */
+int test_rsa_crt() {
+    int errors = 0;
+    uint16_t p[16] = {0x56FD, 0xAC41, 0x8A44, 0xFC2A, 0x7396, 0x4E7D, 0x8B40, 0xD3EC, 0x327F, 0x4306, 0x1275, 0x9A2C, 0x6800, 0x771B, 0x8BB6, 0xCEF2};
+    uint16_t q[16] = {0x0849, 0x8C23, 0x122B, 0x1B24, 0x0C9A, 0xB524, 0xE045, 0x03EA, 0x054E, 0x9240, 0x6B37, 0x90E8, 0xF9F4, 0x677E, 0xB467, 0xCB41};
+    uint16_t dp[16] = {0x7485, 0x5995, 0x1239, 0x90C3, 0xDF87, 0xCEB6, 0x76D9, 0x1723, 0x6F71, 0xE68B, 0x4179, 0x4F73, 0x98B8, 0x10A1, 0xA658, 0x6B9C};
+    uint16_t dq[16] = {0xCD19, 0xA79F, 0x98BC, 0x1039, 0x60FB, 0x6452, 0x01E0, 0xDE84, 0xD880, 0x01D3, 0xE6DF, 0x8D0C, 0x489E, 0xBBC9, 0xD13B, 0x3C92};
+    uint16_t qinv[16] = {0xED0F, 0xDA5A, 0x32C5, 0xA099, 0x5018, 0xEBD7, 0x83AD, 0xEE5B, 0x0B82, 0x3559, 0x0043, 0x1C4C, 0x2403, 0x20BF, 0xC769, 0x83FE};
+    uint16_t n[32] = {0xB625, 0x69F0, 0x41F7, 0x23B6, 0xC692, 0x8195, 0xAC14, 0xFA0C, 0x142B, 0xFD11, 0xB67B, 0x19C6, 0x71C2, 0x2770, 0xCBFB, 0x94B6,
+                      0x3B7D, 0xBCCD, 0xDD56, 0x1501, 0x4FB4, 0xF4B4, 0x10DC, 0x041D, 0xDA80, 0xDA53, 0xF7A2, 0xDF7F, 0xB73D, 0x4B43, 0x7235, 0xA44F};
+    uint16_t e[2] = {0x0001, 0x0001};
+    uint16_t c_0[32] = {0x690E, 0xE424, 0xF666, 0x434C, 0xB48B, 0x81A0, 0x75B7, 0xB037, 0xF8C9, 0x23DA, 0xAD11, 0x6CE8, 0xAAB1, 0x47E5, 0x6877, 0xE56D,
+                        0xB883, 0x476D, 0x190E, 0xE0C1, 0x252E, 0xE591, 0x5F1E, 0x1DA0, 0x3FF4, 0x98A3, 0x2521, 0x8BFC, 0xD9C4, 0x442A, 0x3D13, 0x2718};
+    //c_0^d mod n
+    uint16_t m_0[32] = {0x308A, 0x36CA, 0x2346, 0x6BE2, 0x3961, 0xB2BF, 0xCBBD, 0x6CF3, 0x4EBD, 0x69E3, 0x56BE, 0xDFAC, 0xBE02, 0x3C0B, 0x979C, 0x48C6,
+                        0x19E3, 0xAD7B, 0xCB29, 0x7BF5, 0x0760, 0x879D, 0xE35C, 0xDE58, 0x9F7F, 0x8F43, 0x83F2, 0x4DF1, 0x6909, 0xB23B, 0x063E, 0x52D4};
+    uint16_t d_0[32];
+    rsa_crt_key_t key = {p, q, dp, dq, qinv, n, e, 16, 2};
+
+    if ((M_RSA_OK != rsa_private_crt(d_0, c_0, &key)) || (0 == are_mp_equal(d_0, m_0, 32))) {
+        errors++;
+    }
+    copy_mp(d_0, c_0, 32);
+    if ((M_RSA_OK != rsa_private_crt(d_0, d_0, &key)) || (0 == are_mp_equal(d_0, m_0, 32))) {
+        errors++;
+    }
+    if (M_RSA_ERR_PARAM != rsa_private_crt(d_0, n, &key)) {
+        errors++;
+    }
+    dp[0] ^= 2;
+    if ((M_RSA_ERR_FAULT != rsa_private_crt(d_0, c_0, &key)) || (-1 != mp_non_zero_words(d_0, 32))) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * g^e for g = x(G) and a 192-bit e in 1, 3 and 4 chunks, with the pool of
+ * workers when there are threads
+ */
+int test_split() {
+    int errors = 0;
+    split_pool_t pool;
+    static uint16_t bases[4 * 12];
+    uint16_t g[12] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    uint16_t e[12] = {0x9E37, 0x9E37, 0x9E37, 0x9E37, 0x9E37, 0x9E37, 0xBD77, 0x9E36, 0x9E37, 0x9E37, 0x9E37, 0x9E37};
+    //g^e mod p_192
+    uint16_t c_0[12] = {0xBA67, 0xFBAB, 0xC29F, 0x31FE, 0x7C3E, 0xC557, 0x0D77, 0xB317, 0xF8E6, 0x4FEF, 0x041B, 0xEFB0};
+    uint16_t d_0[12];
+    int chunks[3] = {1, 3, 4};
+    int i, k;
+
+    split_pool_init(&pool, 3);
+    for (i = 0; i < 3; i++) {
+        k = chunks[i];
+        split_bases_p_192(bases, g, k, 192 / k);
+        if ((1 != mod_exp_p_192_split(d_0, &pool, bases, k, 192 / k, e, 12)) || (0 == are_mp_equal(c_0, d_0, 12))) {
+            errors++;
+        }
+        if ((1 != mod_exp_p_192_split(d_0, NULL, bases, k, 192 / k, e, 12)) || (0 == are_mp_equal(c_0, d_0, 12))) {
+            errors++;
+        }
+    }
+    //A on top of e
+    copy_mp(d_0, e, 12);
+    if ((1 != mod_exp_p_192_split(d_0, &pool, bases, 4, 48, d_0, 12)) || (0 == are_mp_equal(c_0, d_0, 12))) {
+        errors++;
+    }
+    //e has 192 bits, two chunks of 64 do not cover it
+    if (0 != mod_exp_p_192_split(d_0, &pool, bases, 2, 64, e, 12)) {
+        errors++;
+    }
+    split_pool_destroy(&pool);
+    return errors;
+}
+
+/*
+ * The SEC 1 uncompressed encoding of the P-192 base point G to limbs and
+ * back, and the hex forms of its coordinates
+ */
+int test_conv() {
+    int errors = 0;
+    uint8_t g_oct[49] = {0x04,
+            0x18, 0x8D, 0xA8, 0x0E, 0xB0, 0x30, 0x90, 0xF6, 0x7C, 0xBF, 0x20, 0xEB, 0x43, 0xA1, 0x88, 0x00, 0xF4, 0xFF, 0x0A, 0xFD, 0x82, 0xFF, 0x10, 0x12,
+            0x07, 0x19, 0x2B, 0x95, 0xFF, 0xC8, 0xDA, 0x78, 0x63, 0x10, 0x11, 0xED, 0x6B, 0x24, 0xCD, 0xD5, 0x73, 0xF9, 0x77, 0xA1, 0x1E, 0x79, 0x48, 0x11};
+    uint16_t g[24] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D,
+                      0x4811, 0x1E79, 0x77A1, 0x73F9, 0xCDD5, 0x6B24, 0x11ED, 0x6310, 0xDA78, 0xFFC8, 0x2B95, 0x0719};
+    const char * x_hex = "188DA80EB03090F67CBF20EB43A18800f4ff0afd82ff1012";
+    const char * g_hex = "188da80eb03090f67cbf20eb43a18800f4ff0afd82ff1012"
+                         "07192b95ffc8da78631011ed6b24cdd573f977a11e794811";
+    uint8_t oct[49];
+    char hex[96];
+    uint16_t d_0[24];
+
+    //1. Octets
+    if ((1 != mp_from_octets(d_0, 12, g_oct + 1, 24)) || (0 == are_mp_equal(d_0, g, 12))) {
+        errors++;
+    }
+    mp_from_octets_n(d_0, 12, g_oct + 1, 2);
+    if (0 == are_mp_equal(d_0, g, 24)) {
+        errors++;
+    }
+    oct[0] = 0x04;
+    mp_to_octets_n(oct + 1, g, 12, 2);
+    if (0 != memcmp(oct, g_oct, 49)) {
+        errors++;
+    }
+    //y(G) needs 24 octets, a leading zero octet is fine
+    if ((0 != mp_to_octets(oct, 23, g + 12, 12)) || (1 != mp_to_octets(oct, 25, g + 12, 12))
+            || (0 != oct[0]) || (0 != memcmp(oct + 1, g_oct + 25, 24))) {
+        errors++;
+    }
+    if ((1 != mp_from_octets(d_0, 12, oct, 25)) || (0 == are_mp_equal(d_0, g + 12, 12))
+            || (0 != mp_from_octets(d_0, 12, g_oct, 25))) {
+        errors++;
+    }
+
+    //2. Hex, either case in and lowercase out
+    if ((1 != mp_from_hex(d_0, 12, x_hex, 48)) || (0 == are_mp_equal(d_0, g, 12))) {
+        errors++;
+    }
+    mp_to_hex_n(hex, g, 12, 2);
+    if (0 != memcmp(hex, g_hex, 96)) {
+        errors++;
+    }
+    if ((1 != mp_from_hex_n(d_0, 12, g_hex, 2)) || (0 == are_mp_equal(d_0, g, 24))
+            || (0 != mp_from_hex(d_0, 12, "12g4", 4))) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * xorshift32 words for the tests, arg points to the state
+ */
+static void test_rng(void * arg, uint16_t * out, uint8_t wordlength) {
+    uint32_t * x = (uint32_t *) arg;
+    int i;
+
+    for (i = 0; i < wordlength; i++) {
+        *x ^= *x << 13;
+        *x ^= *x >> 17;
+        *x ^= *x << 5;
+        out[i] = (uint16_t) (*x >> 8);
+    }
+}
+
+/*
+ * Miller-Rabin on known primes and composites. 2047 = 23*89 is a strong
+ * pseudoprime to base 2, 3825123056546413051 = 149491*747451*34233211 one to
+ * every prime base below 37 and with no factor the trial division finds.
+ */
+int test_prime() {
+    int errors = 0;
+    uint32_t state = 0x2545F491UL;
+    uint16_t n_2047[1] = {2047};
+    uint16_t psp[4] = {0xF9FB, 0x4F9A, 0x9127, 0x3515};
+    uint16_t m127[8] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x7FFF};
+    uint16_t p_192[12] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    //(2^{64} - 59)*(2^{61} - 1)
+    uint16_t pq[8] = {0x003B, 0x0000, 0x0000, 0xA000, 0xFFF7, 0xFFFF, 0xFFFF, 0x1FFF};
+    //561 = 3*11*17 is a Carmichael number
+    uint16_t n_561[1] = {561};
+    uint16_t n_65537[2] = {0x0001, 0x0001};
+    uint16_t base[12] = {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t d_0[8];
+
+    //1. Single rounds
+    if ((1 != miller_rabin(n_2047, 1, base)) || (1 != miller_rabin(psp, 4, base))) {
+        errors++;
+    }
+    base[0] = 3;
+    if ((0 != miller_rabin(n_2047, 1, base)) || (1 != miller_rabin(psp, 4, base))) {
+        errors++;
+    }
+    base[0] = 37;
+    if ((0 != miller_rabin(psp, 4, base)) || (1 != miller_rabin(m127, 8, base)) || (1 != miller_rabin(p_192, 12, base))) {
+        errors++;
+    }
+    //2. Primes and composites
+    if ((1 != is_probable_prime(m127, 8, 8, test_rng, &state)) || (1 != is_probable_prime(p_192, 12, 8, test_rng, &state))
+            || (1 != is_probable_prime(n_65537, 2, 8, test_rng, &state))) {
+        errors++;
+    }
+    if ((0 != is_probable_prime(psp, 4, 8, test_rng, &state)) || (0 != is_probable_prime(pq, 8, 8, test_rng, &state))
+            || (0 != is_probable_prime(n_561, 1, 8, test_rng, &state)) || (0 != is_probable_prime(n_2047, 1, 8, test_rng, &state))) {
+        errors++;
+    }
+    //3. A 128-bit prime with the two top bits set
+    if ((1 != prime_generate(d_0, 8, 128, 8, test_rng, &state)) || (0xC000 != (d_0[7] & 0xC000))
+            || (1 != is_probable_prime(d_0, 8, 8, test_rng, &state))) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * Jacobi symbols, gcd with cofactor and inverses, also with the outputs on
+ * top of the inputs
+ */
+int test_gcd() {
+    int errors = 0;
+    uint16_t a[4][2] = {{1001, 0}, {19, 0}, {8, 0}, {5, 0}};
+    uint16_t n[4][2] = {{9907, 0}, {45, 0}, {21, 0}, {15, 0}};
+    int symbols[4] = {-1, 1, -1, 0};
+    uint16_t p_192[12] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    uint16_t minus_one[12] = {0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    uint16_t g[12] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    //g^{-1} mod p_192
+    uint16_t x_0[12] = {0xC506, 0x296C, 0xD26F, 0xF26B, 0x3AEF, 0xC2CA, 0x82A6, 0x0064, 0xF479, 0x7223, 0xB95D, 0xB795};
+    uint16_t d_0[12];
+    uint16_t m[2];
+    uint16_t x[2];
+    int i;
+
+    //1. Jacobi symbols
+    for (i = 0; i < 4; i++) {
+        if (symbols[i] != jacobi(a[i], n[i], 2)) {
+            errors++;
+        }
+    }
+    if ((-1 != jacobi(minus_one, p_192, 12)) || (1 != jacobi(g, p_192, 12))) {
+        errors++;
+    }
+    //2. gcd(15, 35) = 5 = 15*33 mod 35, g on top of m
+    m[0] = 35;
+    m[1] = 0;
+    a[0][0] = 15;
+    mp_gcd_ext(m, x, a[0], m, 2);
+    if ((5 != m[0]) || (0 != m[1]) || (33 != x[0]) || (0 != x[1])) {
+        errors++;
+    }
+    //3. Inverses, x on top of a, and 15 that has none modulo 35
+    copy_mp(d_0, g, 12);
+    if ((1 != mp_inverse_mod(d_0, d_0, p_192, 12)) || (0 == are_mp_equal(d_0, x_0, 12))) {
+        errors++;
+    }
+    m[0] = 35;
+    if (0 != mp_inverse_mod(x, a[0], m, 2)) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * F_{p^2} arithmetic on a = x(G) + y(G)*i and b = -1 + 3i, in place where
+ * the output may be an input
+ */
+int test_fp2() {
+    int errors = 0;
+    uint16_t a[24] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D,
+                      0x4811, 0x1E79, 0x77A1, 0x73F9, 0xCDD5, 0x6B24, 0x11ED, 0x6310, 0xDA78, 0xFFC8, 0x2B95, 0x0719};
+    uint16_t b[24] = {0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+                      0x0003, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000};
+    //a*b
+    uint16_t a_b[24] = {0x17BA, 0x2195, 0x8E1F, 0xAF14, 0x0E7D, 0x7AF0, 0xA94C, 0x5A10, 0xDFA0, 0x5074, 0xD52F, 0xD226,
+                        0xE825, 0x6A83, 0xA957, 0x6B03, 0xCA2D, 0x5FBF, 0x50D4, 0x132D, 0xD86B, 0x10C8, 0xCC96, 0x428F};
+    //a^2
+    uint16_t a_2[24] = {0xB44A, 0x15D2, 0x9C34, 0xC75C, 0xE313, 0x00A9, 0x2AAA, 0x2BCB, 0x5812, 0xCBE5, 0x2CC2, 0x1271,
+                        0x77D1, 0x0672, 0xAC47, 0x2471, 0x362F, 0xBA70, 0x6204, 0xF0A5, 0x1D0C, 0xD420, 0xB10F, 0x7A73};
+    //a^{-1}
+    uint16_t a_inv[24] = {0xBADB, 0x74A8, 0x5E8B, 0x19D0, 0x5D61, 0x7FD0, 0x2F0D, 0x6331, 0x3EF8, 0x9167, 0x713B, 0x515E,
+                          0x4241, 0xA7A8, 0x1C23, 0x5EB2, 0xB256, 0x6DBE, 0x96F7, 0x6254, 0xDED4, 0x8F4B, 0xE391, 0xBE90};
+    uint16_t a_plus_b[24] = {0x1011, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D,
+                             0x4814, 0x1E79, 0x77A1, 0x73F9, 0xCDD5, 0x6B24, 0x11ED, 0x6310, 0xDA78, 0xFFC8, 0x2B95, 0x0719};
+    uint16_t a_minus_b[24] = {0x1013, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D,
+                              0x480E, 0x1E79, 0x77A1, 0x73F9, 0xCDD5, 0x6B24, 0x11ED, 0x6310, 0xDA78, 0xFFC8, 0x2B95, 0x0719};
+    //norm(a) = x(G)^2 + y(G)^2
+    uint16_t n_0[12] = {0x074D, 0xA23F, 0x71C7, 0x98FD, 0x7B28, 0xA78B, 0xF425, 0x50F0, 0x6A29, 0x88FD, 0x9630, 0x0137};
+    uint16_t zero[24] = {0};
+    uint16_t d_0[24];
+
+    multiply_fp2_p_192(d_0, a, b);
+    if (0 == are_mp_equal(d_0, a_b, 24)) {
+        errors++;
+    }
+    copy_mp(d_0, a, 24);
+    square_fp2_p_192(d_0, d_0);
+    if (0 == are_mp_equal(d_0, a_2, 24)) {
+        errors++;
+    }
+    copy_mp(d_0, a, 24);
+    multiply_fp2_p_192(d_0, d_0, d_0);
+    if (0 == are_mp_equal(d_0, a_2, 24)) {
+        errors++;
+    }
+    add_fp2_p_192(d_0, a, b);
+    if (0 == are_mp_equal(d_0, a_plus_b, 24)) {
+        errors++;
+    }
+    subtract_fp2_p_192(d_0, a, b);
+    if (0 == are_mp_equal(d_0, a_minus_b, 24)) {
+        errors++;
+    }
+    norm_fp2_p_192(d_0, a);
+    if (0 == are_mp_equal(d_0, n_0, 12)) {
+        errors++;
+    }
+    copy_mp(d_0, a, 24);
+    if ((1 != inverse_fp2_p_192(d_0, d_0)) || (0 == are_mp_equal(d_0, a_inv, 24))) {
+        errors++;
+    }
+    //a*a^{-1} = 1
+    multiply_fp2_p_192(d_0, d_0, a);
+    if ((1 != d_0[0]) || (-1 != mp_non_zero_words(d_0 + 1, 23))) {
+        errors++;
+    }
+    if (0 != inverse_fp2_p_192(d_0, zero)) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * Every output that m_defs.h does not mark M_RESTRICT may be one of the
+ * inputs: the aliased calls must match the ones into separate buffers.
+ * g*g^{-1} = 1 mod p_192 gives the known answer for the product.
+ */
+int test_alias() {
+    int errors = 0;
+    mont_ctx_t ctx;
+    uint16_t p_192[12] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    uint16_t g[12] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    //g^{-1} mod p_192
+    uint16_t x_0[12] = {0xC506, 0x296C, 0xD26F, 0xF26B, 0x3AEF, 0xC2CA, 0x82A6, 0x0064, 0xF479, 0x7223, 0xB95D, 0xB795};
+    uint16_t one[12] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t ab[24];
+    uint16_t ab2[24];
+    uint16_t t[24];
+    uint16_t c_0[12];
+    uint16_t d_0[12];
+
+    //1. g*g^{-1} by both multiplications, reduced into a separate buffer and in place
+    multiply_mp_elements(ab, g, x_0, 12);
+    multiply_mp_elements2(ab2, g, 12, x_0, 12);
+    if (0 == are_mp_equal(ab, ab2, 24)) {
+        errors++;
+    }
+    reduce_mod_p(ab, p_192, c_0);
+    copy_mp(t, ab, 24);
+    reduce_mod_p(t, p_192, t);
+    if ((0 == are_mp_equal(c_0, one, 12)) || (0 == are_mp_equal(c_0, t, 12))) {
+        errors++;
+    }
+    //2. The remainder of the division on top of a and on top of b
+    divide_mp_elements(NULL, c_0, ab, 24, p_192, 12);
+    copy_mp(t, ab, 24);
+    divide_mp_elements(NULL, t, t, 24, p_192, 12);
+    copy_mp(d_0, p_192, 12);
+    divide_mp_elements(NULL, d_0, ab, 24, d_0, 12);
+    if ((0 == are_mp_equal(c_0, one, 12)) || (0 == are_mp_equal(c_0, t, 12)) || (0 == are_mp_equal(c_0, d_0, 12))) {
+        errors++;
+    }
+    //3. Addition and subtraction with c on top of a and of b
+    add_mod_p(c_0, g, x_0, p_192, 12);
+    copy_mp(d_0, g, 12);
+    add_mod_p(d_0, d_0, x_0, p_192, 12);
+    copy_mp(t, x_0, 12);
+    add_mod_p(t, g, t, p_192, 12);
+    if ((0 == are_mp_equal(c_0, d_0, 12)) || (0 == are_mp_equal(c_0, t, 12))) {
+        errors++;
+    }
+    subtract_mod_p(c_0, g, x_0, p_192, 12);
+    copy_mp(d_0, g, 12);
+    subtract_mod_p(d_0, d_0, x_0, p_192, 12);
+    copy_mp(t, x_0, 12);
+    subtract_mod_p(t, g, t, p_192, 12);
+    if ((0 == are_mp_equal(c_0, d_0, 12)) || (0 == are_mp_equal(c_0, t, 12))) {
+        errors++;
+    }
+    //4. g^{g^{-1}} with A on top of g and of e
+    mont_setup(&ctx, p_192, 12);
+    mont_exp(&ctx, c_0, g, x_0, 12);
+    copy_mp(d_0, g, 12);
+    mont_exp(&ctx, d_0, d_0, x_0, 12);
+    copy_mp(t, x_0, 12);
+    mont_exp(&ctx, t, g, t, 12);
+    if ((0 == are_mp_equal(c_0, d_0, 12)) || (0 == are_mp_equal(c_0, t, 12))) {
+        errors++;
+    }
+    mod_exp_p_192(d_0, g, x_0, 12);
+    if (0 == are_mp_equal(c_0, d_0, 12)) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * The fixed-schedule exponentiations of g = x(G): g^{p-2} = g^{-1}, a 192-bit
+ * and a 32-bit exponent, the exponents 0 and 1, and A on top of g
+ */
+int test_exp_ct() {
+    int errors = 0;
+    void (*exp[2])(uint16_t *, uint16_t *, uint16_t *, uint16_t) = {mod_exp_p_192_ct, mod_exp_p_192_ladder};
+    uint16_t g[12] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    uint16_t p_minus_2[12] = {0xFFFD, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    //g^{-1} mod p_192
+    uint16_t x_0[12] = {0xC506, 0x296C, 0xD26F, 0xF26B, 0x3AEF, 0xC2CA, 0x82A6, 0x0064, 0xF479, 0x7223, 0xB95D, 0xB795};
+    uint16_t e[12] = {0x9E37, 0x9E37, 0x9E37, 0x9E37, 0x9E37, 0x9E37, 0xBD77, 0x9E36, 0x9E37, 0x9E37, 0x9E37, 0x9E37};
+    //g^e mod p_192
+    uint16_t c_0[12] = {0xBA67, 0xFBAB, 0xC29F, 0x31FE, 0x7C3E, 0xC557, 0x0D77, 0xB317, 0xF8E6, 0x4FEF, 0x041B, 0xEFB0};
+    uint16_t e_32[3] = {0xBEEF, 0xDEAD, 0x0000};
+    //g^0xDEADBEEF mod p_192
+    uint16_t c_1[12] = {0xA11D, 0xADD7, 0xAC0B, 0x4DD3, 0xED87, 0x0236, 0x411B, 0x3357, 0xA5CB, 0xE958, 0xEAFB, 0x5202};
+    uint16_t zero[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t one[12] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t d_0[12];
+    int i;
+
+    for (i = 0; i < 2; i++) {
+        exp[i](d_0, g, p_minus_2, 12);
+        if (0 == are_mp_equal(x_0, d_0, 12)) {
+            errors++;
+        }
+        exp[i](d_0, g, e, 12);
+        if (0 == are_mp_equal(c_0, d_0, 12)) {
+            errors++;
+        }
+        exp[i](d_0, g, e_32, 3);
+        if (0 == are_mp_equal(c_1, d_0, 12)) {
+            errors++;
+        }
+        //0 of one and of twelve words, then 1
+        exp[i](d_0, g, zero, 1);
+        if (0 == are_mp_equal(one, d_0, 12)) {
+            errors++;
+        }
+        exp[i](d_0, g, zero, 12);
+        if (0 == are_mp_equal(one, d_0, 12)) {
+            errors++;
+        }
+        exp[i](d_0, g, one, 12);
+        if (0 == are_mp_equal(g, d_0, 12)) {
+            errors++;
+        }
+        copy_mp(d_0, g, 12);
+        exp[i](d_0, d_0, e, 12);
+        if (0 == are_mp_equal(c_0, d_0, 12)) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+/*
+ * y^2 + x*y = x^3 + x^2 + b for (x, y) on a NIST B-curve, a = 1
+ */
+static int on_b_curve(uint16_t * x, uint16_t * y, uint16_t * b, const gf2m_field_t * f) {
+    //Static, gf2m_multiply needs most of the stack
+    static uint16_t l[GF2M_MAX_WORDLENGTH];
+    static uint16_t r[GF2M_MAX_WORDLENGTH];
+    static uint16_t t[GF2M_MAX_WORDLENGTH];
+
+    gf2m_square(l, y, f);
+    gf2m_multiply(t, x, y, f);
+    gf2m_add(l, l, t, f);
+    gf2m_square(r, x, f);
+    gf2m_multiply(t, x, r, f);
+    gf2m_add(r, r, t, f);
+    gf2m_add(r, r, b, f);
+    return are_mp_equal(l, r, f->wordlength);
+}
+
+/*
+ * The base points of the NIST curves B-163 to B-571 of FIPS 186-3 Appendix
+ * D.1.3 satisfy their curve equations, and x*y and x^2 of B-163
+ */
+int test_gf2m() {
+    int errors = 0;
+    static uint16_t x_163[11] = {0x3E36, 0xE834, 0x4637, 0xD499, 0x1168, 0xA099, 0xD57E, 0x86A2, 0xA162, 0xF0EB, 0x0003};
+    static uint16_t y_163[11] = {0x24F1, 0x7973, 0x5C0C, 0xB11C, 0xD545, 0xA2CD, 0x094F, 0x71A0, 0xBC6C, 0xD51F, 0x0000};
+    static uint16_t b_163[11] = {0x05FD, 0x4A32, 0x7874, 0x512F, 0xEB10, 0x1481, 0x53CA, 0xB8C9, 0x1907, 0x0A60, 0x0002};
+    static uint16_t x_233[15] = {0x558B, 0x71FD, 0xEB73, 0xF8F8, 0x8B36, 0x391F, 0x65BC, 0x5FEF, 0xBB75, 0x39F1, 0xBB21, 0x8313,
+            0xCBAC, 0xC9DF, 0x00FA};
+    static uint16_t y_233[15] = {0x1052, 0x01F8, 0x6F7E, 0x3671, 0xA7CA, 0xF867, 0x0BEF, 0xBF8A, 0x28BE, 0xE585, 0x0678, 0x0335,
+            0xA419, 0x6A08, 0x0100};
+    static uint16_t b_233[15] = {0x90AD, 0x7D8F, 0x115F, 0x81FE, 0xCE42, 0x20E9, 0x333B, 0x213B, 0xBB58, 0x0923, 0x7F8C, 0x332C,
+            0xDE6C, 0x647E, 0x0066};
+    static uint16_t x_283[18] = {0x2053, 0x86B1, 0xBECD, 0xF8CD, 0xE198, 0x80E2, 0xAC9C, 0x557E, 0x25B8, 0x2EED, 0xDFEC, 0x70B0,
+            0x4F8C, 0xE193, 0xDD90, 0x8DB7, 0x3925, 0x05F9};
+    static uint16_t y_283[18] = {0x12F4, 0xBE81, 0xDF45, 0x13F0, 0x79C8, 0x8267, 0xDDB0, 0x350E, 0xF702, 0x516F, 0x02B4, 0xB20D,
+            0xE6D4, 0xB98F, 0x141C, 0xFE24, 0x6854, 0x0367};
+    static uint16_t b_283[18] = {0xA2F5, 0x3B79, 0x3E31, 0xF626, 0x485A, 0xA581, 0x9FA2, 0x4530, 0xFD76, 0xCA97, 0x303F, 0x19A0,
+            0xAF8A, 0xA5A4, 0x596D, 0xC8B8, 0x680A, 0x027B};
+    static uint16_t x_409[26] = {0x96A7, 0xBB79, 0x4E54, 0x6079, 0xAEAB, 0x5603, 0x8051, 0x8A11, 0x5A86, 0xDC25, 0x9703, 0x34E5,
+            0xFE5B, 0xB01F, 0x1D4D, 0xF177, 0xDE4A, 0x441C, 0x6260, 0x6475, 0x0C60, 0x496B, 0xDDB3, 0xD088,
+            0x4860, 0x015D};
+    static uint16_t y_409[26] = {0xC706, 0x0273, 0x64BA, 0x81C3, 0x1B36, 0xD218, 0x4F40, 0xDF4B, 0x4F1F, 0x3851, 0xD08F, 0x5488,
+            0xAA4F, 0x0158, 0x198D, 0xA7BD, 0xB9C5, 0x7636, 0x106A, 0x24ED, 0xA783, 0x2BBF, 0xE5F3, 0xAB6B,
+            0xB1CF, 0x0061};
+    static uint16_t b_409[26] = {0x545F, 0x7B13, 0xAE31, 0x4F50, 0x55AA, 0xD57A, 0x2F6C, 0x7282, 0x97B2, 0xA9A1, 0x27C8, 0xD6AC,
+            0xFA99, 0x4761, 0xDD67, 0xF1F3, 0x422E, 0x7FD6, 0x476B, 0x3B7B, 0x9A75, 0x5C4B, 0x9FEB, 0xC8EE,
+            0xA5C2, 0x0021};
+    static uint16_t x_571[36] = {0x2D19, 0x8EEC, 0x769C, 0xE1E7, 0xD927, 0xC850, 0xA3B4, 0x4ABF, 0xF139, 0x8614, 0x6003, 0x99AE,
+            0xFB14, 0x5B67, 0x11A3, 0xCDD7, 0xD293, 0xF4C0, 0x3950, 0xBDE5, 0x2ABD, 0xDB7B, 0x0FC8, 0xA5F4,
+            0xA80A, 0x955F, 0xD1D2, 0x0A93, 0xD775, 0x0D3C, 0xC0D4, 0x6C16, 0x5629, 0x34B8, 0x001D, 0x0303};
+    static uint16_t y_571[36] = {0xC15B, 0x1B8A, 0x27AF, 0x1A48, 0xDD3C, 0x6E23, 0xF151, 0x16E2, 0xC19B, 0x0485, 0x1D2F, 0xB353,
+            0xB2A8, 0x461B, 0xAF8F, 0x6291, 0x8A57, 0xBAB0, 0x3E43, 0x8442, 0xE8A6, 0x3921, 0xF853, 0x1980,
+            0xBBCA, 0x009C, 0x27A6, 0x8C6C, 0x69D7, 0xB73D, 0xFFFE, 0x6DCC, 0x639B, 0x42DA, 0xF273, 0x037B};
+    static uint16_t b_571[36] = {0x727A, 0x2955, 0xFF7F, 0x7FFE, 0xCA0C, 0x39BA, 0x4DE7, 0x520E, 0x12AA, 0x78FF, 0x185A, 0x4AFD,
+            0x6E29, 0x56A6, 0xAD67, 0x2BE7, 0x5933, 0x8EFA, 0xABBD, 0x84FF, 0x18AD, 0x4A9A, 0xA8CE, 0xCD6B,
+            0xEFF1, 0xCB8C, 0x97FF, 0x5C6A, 0xD62F, 0xB7F3, 0x7117, 0xDE29, 0xF295, 0x2221, 0x0E7E, 0x02F4};
+    //x*y and x^2 of B-163
+    uint16_t xy_163[11] = {0x9B04, 0x1A71, 0xB8EE, 0x46DD, 0x041E, 0xB45A, 0xF030, 0x2E09, 0x7EE4, 0xAA80, 0x0007};
+    uint16_t xx_163[11] = {0x564B, 0xA9D2, 0xCD08, 0x16EA, 0xA9F6, 0xD9E4, 0x97A3, 0xDD88, 0xACF3, 0x06A6, 0x0003};
+    uint16_t c_0[11];
+
+    if ((1 != on_b_curve(x_163, y_163, b_163, &gf2m_f163)) || (1 != on_b_curve(x_233, y_233, b_233, &gf2m_f233))
+            || (1 != on_b_curve(x_283, y_283, b_283, &gf2m_f283)) || (1 != on_b_curve(x_409, y_409, b_409, &gf2m_f409))
+            || (1 != on_b_curve(x_571, y_571, b_571, &gf2m_f571))) {
+        errors++;
+    }
+    gf2m_multiply(c_0, x_163, y_163, &gf2m_f163);
+    if (0 == are_mp_equal(c_0, xy_163, 11)) {
+        errors++;
+    }
+    gf2m_square(c_0, x_163, &gf2m_f163);
+    if (0 == are_mp_equal(c_0, xx_163, 11)) {
+        errors++;
+    }
+    gf2m_multiply(c_0, x_163, x_163, &gf2m_f163);
+    if (0 == are_mp_equal(c_0, xx_163, 11)) {
+        errors++;
+    }
+    //x is not on B-233 with y and b swapped
+    if (0 != on_b_curve(x_233, b_233, y_233, &gf2m_f233)) {
+        errors++;
+    }
+    return errors;
+}
+
+/*
+ * RNS round trips and products modulo p_192, where g*g^{-1} = 1, and modulo
+ * the two-word prime 1000003
+ */
+int test_rns() {
+    int errors = 0;
+    static rns_ctx_t ctx;
+    static uint16_t X[2 * RNS_MAX_BASE];
+    static uint16_t Y[2 * RNS_MAX_BASE];
+    uint16_t p_192[12] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFE, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF};
+    uint16_t g[12] = {0x1012, 0x82FF, 0x0AFD, 0xF4FF, 0x8800, 0x43A1, 0x20EB, 0x7CBF, 0x90F6, 0xB030, 0xA80E, 0x188D};
+    //g^{-1} mod p_192
+    uint16_t x_0[12] = {0xC506, 0x296C, 0xD26F, 0xF26B, 0x3AEF, 0xC2CA, 0x82A6, 0x0064, 0xF479, 0x7223, 0xB95D, 0xB795};
+    uint16_t one[12] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint16_t n[2] = {0x4243, 0x000F};
+    uint16_t a[2] = {0xE240, 0x0001};
+    uint16_t b[2] = {0xFBF1, 0x0009};
+    uint16_t n_minus_1[2] = {0x4242, 0x000F};
+    uint16_t n_minus_2[2] = {0x4241, 0x000F};
+    //123456*654321 mod 1000003
+    uint16_t ab[2] = {0x52DF, 0x0009};
+    uint16_t d_0[12];
+
+    //1. Modulo p_192
+    if (1 != rns_setup(&ctx, p_192, 12)) {
+        return 1;
+    }
+    rns_from_mp(&ctx, X, g);
+    rns_to_mp(&ctx, d_0, X);
+    if (0 == are_mp_equal(d_0, g, 12)) {
+        errors++;
+    }
+    rns_from_mp(&ctx, Y, x_0);
+    rns_multiply(&ctx, X, X, Y);
+    rns_to_mp(&ctx, d_0, X);
+    if (0 == are_mp_equal(d_0, one, 12)) {
+        errors++;
+    }
+    //2. Modulo 1000003, with the sum of two products multiplied again
+    if (1 != rns_setup(&ctx, n, 2)) {
+        return errors + 1;
+    }
+    rns_from_mp(&ctx, X, a);
+    rns_from_mp(&ctx, Y, b);
+    rns_multiply(&ctx, X, X, Y);
+    rns_to_mp(&ctx, d_0, X);
+    if (0 == are_mp_equal(d_0, ab, 2)) {
+        errors++;
+    }
+    rns_from_mp(&ctx, X, n_minus_1);
+    rns_to_mp(&ctx, d_0, X);
+    if (0 == are_mp_equal(d_0, n_minus_1, 2)) {
+        errors++;
+    }
+    rns_multiply(&ctx, Y, X, X);
+    rns_add(&ctx, Y, Y, Y);
+    rns_multiply(&ctx, Y, Y, X);
+    rns_to_mp(&ctx, d_0, Y);
+    //2*(n-1)^3 = -2 mod n
+    if (0 == are_mp_equal(d_0, n_minus_2, 2)) {
+        errors++;
+    }
+    //N even is rejected
+    n[0] ^= 1;
+    if (0 != rns_setup(&ctx, n, 2)) {
+        errors++;
+    }
+    return errors;
 }
 
 int main( void )
 {
+  int errors = 0;
+
   // Stop watchdog timer to prevent time out reset
   WDTCTL = WDTPW + WDTHOLD;
-  test_sum();
-  return 0;
+  errors += test_sum();
+  errors += test_table();
+  errors += test_sqrt();
+  errors += test_rsa_crt();
+  errors += test_split();
+  errors += test_conv();
+  errors += test_prime();
+  errors += test_gcd();
+  errors += test_fp2();
+  errors += test_alias();
+  errors += test_exp_ct();
+  errors += test_gf2m();
+  errors += test_rns();
+  return errors;
 }